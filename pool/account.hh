@@ -0,0 +1,95 @@
+#ifndef LWE_ACCOUNT_HEADER
+#define LWE_ACCOUNT_HEADER
+
+#include "config.hh"
+
+namespace lwe {
+namespace mem {
+
+/*******************************************************************************
+ * per subsystem memory accounting
+ *
+ * tag
+ *  - 0 ~ MAX - 1: user defined, 0 is default (untagged).
+ *  - NONE: not counted, used for internal memory. (pool block, node cache)
+ *
+ * attribution
+ *  - allocator::malloc: current scope tag of calling thread, kept with memory.
+ *    allocator::free uncounts that tag, whatever scope it is called in.
+ *  - pool construct / destruct: tag of pool, captured when pool is created,
+ *    or set by tag(), or 'static constexpr size_t account' of statics Tag type.
+ *  - internal memory of containers (deque map, queue buffers): NONE.
+ *
+ * counters are thread local, written by owner only. (relaxed, no RMW)
+ * free on other thread is negative there, sum of all threads is exact.
+ * after counter is destroyed at thread end, add goes to retired under lock.
+ *
+ * how to use
+ *
+ * @code {.cpp}
+ *  enum { E_ORDER_BOOK = 1, E_NETWORK = 2 };
+ *  {
+ *      account::scope tag(E_NETWORK);
+ *      void* buffer = allocator::malloc(4096);     // counted to E_NETWORK
+ *      pool  local(64);                            // chunks counted to E_NETWORK
+ *  }
+ *  account::usage used = account::total(E_NETWORK); // aggregate
+ * @endcode
+ ******************************************************************************/
+class account {
+public:
+    account() = delete;
+
+public:
+    enum : size_t {
+        MAX  = 16,
+        NONE = size_t(-1),
+    };
+
+private:
+    /// @brief thread local counters
+    struct counter;
+
+public:
+    /// @brief aggregated value
+    struct usage {
+        int64_t bytes;
+        int64_t count;
+    };
+
+public:
+    /// @brief RAII thread local tag
+    class scope {
+    public:
+        scope(size_t tag) noexcept: prev(current()) { current() = tag; }
+        ~scope() noexcept { current() = prev; }
+
+    private:
+        size_t prev;
+    };
+
+public:
+    /// @brief current tag of thread
+    static size_t& current() noexcept;
+
+public:
+    /// @brief add to thread local counter, NONE or out of range is ignored
+    static void add(size_t tag, int64_t bytes, int64_t count) noexcept;
+
+public:
+    /// @brief sum of all threads, include ended threads
+    static usage total(size_t tag) noexcept;
+
+private:
+    /// @brief nullptr: destroyed at thread end
+    static counter* local() noexcept;
+    static std::mutex& locker() noexcept;
+    static std::unordered_set<counter*>& registry() noexcept;
+    static usage (&retired() noexcept)[MAX];
+};
+
+} // namespace mem
+} // namespace lwe
+
+#include "account.inl"
+#endif
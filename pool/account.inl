@@ -0,0 +1,100 @@
+#include "account.hh"
+
+namespace lwe {
+namespace mem {
+
+struct account::counter {
+    counter() noexcept {
+        for(size_t i = 0; i < MAX; ++i) {
+            bytes[i].store(0, std::memory_order_relaxed);
+            count[i].store(0, std::memory_order_relaxed);
+        }
+        std::lock_guard<std::mutex> guard(locker());
+        registry().insert(this);
+    }
+
+    /// @brief fold into retired
+    ~counter() noexcept {
+        std::lock_guard<std::mutex> guard(locker());
+        for(size_t i = 0; i < MAX; ++i) {
+            retired()[i].bytes += bytes[i].load(std::memory_order_relaxed);
+            retired()[i].count += count[i].load(std::memory_order_relaxed);
+        }
+        registry().erase(this);
+    }
+
+    std::atomic<int64_t> bytes[MAX];
+    std::atomic<int64_t> count[MAX];
+};
+
+size_t& account::current() noexcept {
+    static thread_local size_t tag = 0;
+    return tag;
+}
+
+void account::add(size_t tag, int64_t bytes, int64_t count) noexcept {
+    if(tag >= MAX) {
+        return;
+    }
+
+    // counter is destroyed at thread end: to retired directly
+    counter* self = local();
+    if(!self) {
+        std::lock_guard<std::mutex> guard(locker());
+        retired()[tag].bytes += bytes;
+        retired()[tag].count += count;
+        return;
+    }
+
+    // owner only: not RMW
+    self->bytes[tag].store(self->bytes[tag].load(std::memory_order_relaxed) + bytes, std::memory_order_relaxed);
+    self->count[tag].store(self->count[tag].load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+}
+
+auto account::total(size_t tag) noexcept -> usage {
+    if(tag >= MAX) {
+        return {};
+    }
+
+    std::lock_guard<std::mutex> guard(locker());
+    usage out = retired()[tag];
+    for(counter* i : registry()) {
+        out.bytes += i->bytes[tag].load(std::memory_order_relaxed);
+        out.count += i->count[tag].load(std::memory_order_relaxed);
+    }
+    return out;
+}
+
+auto account::local() noexcept -> counter* {
+    // trivial: readable by thread locals destroyed after counter
+    static thread_local bool ended = false;
+    if(ended) {
+        return nullptr;
+    }
+
+    struct holder {
+        ~holder() noexcept { ended = true; }
+        counter instance;
+    };
+    static thread_local holder keep;
+    return &keep.instance;
+}
+
+// not destroyed: counters can be touched by other static destructors
+std::mutex& account::locker() noexcept {
+    static std::mutex* instance = new std::mutex();
+    return *instance;
+}
+
+std::unordered_set<account::counter*>& account::registry() noexcept {
+    static std::unordered_set<counter*>* instance = new std::unordered_set<counter*>();
+    return *instance;
+}
+
+auto account::retired() noexcept -> usage (&)[MAX] {
+    static usage instance[MAX] = {};
+    return instance;
+}
+
+} // namespace mem
+} // namespace lwe
@@ -3,6 +3,8 @@
 
 #include "config.hh"
 #include "aligner.hh"
+#include "quota.hh"
+#include "account.hh"
 
 namespace lwe {
 namespace mem {
@@ -13,6 +15,7 @@ namespace mem {
  * 
  * caching occurs 'free' is when called, but not thread-safe.
  * 'statics()' is thread-safe: use 'thread_local'.
+ * 'statics()' is nullptr after it is destroyed at thread end: use malloc / free.
  * static mehod is thread-safe but are not cached.
  *
  * NOTE: this class for RAII, instance creation is not recommended.
@@ -20,7 +23,12 @@ namespace mem {
 class allocator {
 public:
     /// @brief aligned malloc, size and align is adjust
+    /// @note  charged to quota::global(), nullptr when over hard limit
+    /// @note  counted to account::current() tag, kept in header before pointer with size
     static void* malloc(size_t size, size_t align = config::DEF_ALIGN) noexcept;
+
+    /// @brief free, size of malloc is read from header: uncharged from quota and account
+    /// @note  uncounted from tag of malloc, any scope or thread
     static void  free(void*) noexcept;
 
 public:
@@ -34,21 +42,39 @@ public:
     allocator& operator=(allocator&&)      = delete;
 
 public:
+    /// @brief cached first, malloc when empty
     void* allocate() noexcept;
+
+    /// @brief cache until full, free when full
     void  deallocate(void*) noexcept;
 
+public:
+    /// @brief cache usage of allocate
+    struct stats {
+        size_t hits;   // from cache
+        size_t misses; // from malloc
+        size_t cached; // current count
+    };
+
+public:
+    stats report() const noexcept;
+
 private:
     const size_t ALIGN;
     const size_t SIZE;
     const size_t CACHE;
 
 private:
-    size_t count;
-    void** stack = nullptr;
+    size_t count  = 0;
+    void** stack  = nullptr;
+    size_t hits   = 0;
+    size_t misses = 0;
 
 public:
+    /// @brief thread local instance
+    /// @return nullptr: destroyed, called by other thread local destructor at thread end
     template<size_t Size, size_t Align = config::DEF_ALIGN, size_t Cache = config::DEF_CACHE>
-    static allocator& statics() noexcept;
+    static allocator* statics() noexcept;
 };
 
 } // namespace mem
@@ -1,27 +1,69 @@
 namespace lwe {
 namespace mem {
 
-template<size_t Size, size_t Align, size_t Cache> allocator& allocator::statics() noexcept {
-    static thread_local allocator instance(Size, Align, Cache);
-    return instance;
+template<size_t Size, size_t Align, size_t Cache> allocator* allocator::statics() noexcept {
+    // trivial: readable after instance is destroyed
+    static thread_local bool ended = false;
+    if(ended) {
+        return nullptr;
+    }
+
+    struct holder {
+        ~holder() noexcept { ended = true; }
+        allocator instance{ Size, Align, Cache };
+    };
+    static thread_local holder keep;
+    return &keep.instance;
 }
 
 void* allocator::malloc(size_t size, size_t align) noexcept {
-    align = util::aligner::boundary(align);
-    size  = util::aligner::padding(size, align);
+    if(!quota::global().charge(size)) {
+        return nullptr;
+    }
+
+    // header: offset to raw, tag and size, read by free
+    size_t bytes = size;
+    align        = util::aligner::boundary(align);
+    size_t head  = util::aligner::padding(sizeof(size_t) * 3, align);
+    size         = util::aligner::padding(size + head, align);
 
 #if _WIN32
-    return _aligned_malloc(size, align);
+    uint8_t* raw = static_cast<uint8_t*>(_aligned_malloc(size, align));
 #else
-    return std::aligned_alloc(align, size);
+    uint8_t* raw = static_cast<uint8_t*>(std::aligned_alloc(align, size));
 #endif
+
+    if(!raw) {
+        quota::global().uncharge(bytes);
+        return nullptr;
+    }
+
+    size_t  tag  = account::current();
+    size_t* meta = reinterpret_cast<size_t*>(raw + head);
+    meta[-1]     = tag;
+    meta[-2]     = head;
+    meta[-3]     = bytes;
+
+    account::add(tag, bytes, 1);
+    return raw + head;
 }
 
 void allocator::free(void* in) noexcept {
+    if(!in) {
+        return;
+    }
+
+    // tag and size of malloc, not of current scope
+    size_t* meta = static_cast<size_t*>(in);
+    size_t  size = meta[-3];
+    quota::global().uncharge(size);
+    account::add(meta[-1], -int64_t(size), -1);
+
+    uint8_t* raw = static_cast<uint8_t*>(in) - meta[-2];
 #ifdef _WIN32
-    _aligned_free(in);
+    _aligned_free(raw);
 #else
-    std::free(in);
+    std::free(raw);
 #endif
 }
 
@@ -29,12 +71,12 @@ void allocator::free(void* in) noexcept {
 allocator::allocator(size_t size, size_t align, size_t cache) noexcept:
     ALIGN{ util::aligner::boundary(align) },
     SIZE{  util::aligner::padding(size, ALIGN) },
-    CACHE{ cache },
-    stack(nullptr)
+    CACHE{ cache }
 {}
 // clanf-format on
     
 allocator::~allocator() noexcept {
+    account::scope internal(account::NONE);
     if(stack) {
         for(size_t i = 0; i < count; ++i) {
             free(stack[i]);
@@ -44,20 +86,31 @@ allocator::~allocator() noexcept {
 }
 
 void* allocator::allocate() noexcept {
+    account::scope internal(account::NONE);
     if(count) {
-        if(stack) {
-            return stack[--count];
-        }
-        return nullptr;
+        ++hits;
+        return stack[--count];
     }
+    ++misses;
     return malloc(SIZE, ALIGN);
 }
 
 void allocator::deallocate(void* in) noexcept {
+    account::scope internal(account::NONE);
+
+    // lazy: not cached allocator has no stack
+    if(!stack && CACHE) {
+        stack = static_cast<void**>(malloc(sizeof(void*) * CACHE));
+    }
+
     if(stack && count < CACHE) {
         stack[count++] = in;
     } else free(in);
 }
 
+auto allocator::report() const noexcept -> stats {
+    return { hits, misses, count };
+}
+
 } // namespace mem
 } // namespace lwe
\ No newline at end of file
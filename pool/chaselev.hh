@@ -0,0 +1,70 @@
+#ifndef LWE_CHASELEV_HEADER
+#define LWE_CHASELEV_HEADER
+
+#include "allocator.hh"
+
+namespace lwe {
+namespace data {
+
+/*******************************************************************************
+ * Chase-Lev work-stealing deque (Le et al. 2013, C11 memory model version)
+ *
+ * - owner: push / take at bottom (like deque push / lifo)
+ * - thief: steal at top          (like deque fifo)
+ *
+ * node is { mask, retired, atomic<T>[mask + 1] }, 'Size' is initial capacity.
+ * it is circular, when full, new node is allocated with doubled capacity.
+ * old nodes can be read by thieves, so these are linked from the new node
+ * and kept until destroyed: growing does not allocate but the new node.
+ *
+ * NOTE: T must be trivially copyable and lock-free atomic (pointer, integer).
+ ******************************************************************************/
+template<typename T, size_t Size = config::DEF_CACHE, size_t Align = config::DEF_ALIGN> class chaselev {
+    static_assert(util::aligner::check(Size), "Size must be power of 2");
+
+    struct node;
+
+public:
+    chaselev();
+    ~chaselev();
+
+public:
+    chaselev(const chaselev&)            = delete;
+    chaselev(chaselev&&)                 = delete;
+    chaselev& operator=(const chaselev&) = delete;
+    chaselev& operator=(chaselev&&)      = delete;
+
+public:
+    /// @brief push bottom, owner only
+    /// @return false: failed to grow
+    bool push(T);
+
+public:
+    /// @brief pop bottom, owner only
+    /// @return false: at empty
+    bool take(T*);
+
+public:
+    /// @brief pop top, any thread
+    /// @return false: at empty or lost race
+    bool steal(T*);
+
+public:
+    /// @brief approximate size
+    size_t size() const;
+
+private:
+    /// @brief allocate node, capacity is power of 2
+    static node* create(size_t);
+
+private:
+    alignas(64) std::atomic<int64_t> head; // top
+    alignas(64) std::atomic<int64_t> tail; // bottom
+    std::atomic<node*>               array;
+};
+
+} // namespace data
+} // namespace lwe
+
+#include "chaselev.inl"
+#endif
@@ -0,0 +1,124 @@
+#include "chaselev.hh"
+
+namespace lwe {
+namespace data {
+
+template<typename T, size_t Size, size_t Align> struct chaselev<T, Size, Align>::node {
+    size_t mask;
+    node*  retired; // smaller node before grown, can be read by thieves
+
+    /// @brief circular array is after header
+    std::atomic<T>* array() { return reinterpret_cast<std::atomic<T>*>(this + 1); }
+
+    T    get(int64_t i) { return array()[i & mask].load(std::memory_order_relaxed); }
+    void put(int64_t i, T in) { array()[i & mask].store(in, std::memory_order_relaxed); }
+};
+
+template<typename T, size_t Size, size_t Align> chaselev<T, Size, Align>::chaselev() {
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+    array.store(create(Size), std::memory_order_relaxed);
+}
+
+template<typename T, size_t Size, size_t Align> chaselev<T, Size, Align>::~chaselev() {
+    node* a = array.load(std::memory_order_relaxed);
+    while(a) {
+        node* old = a->retired;
+        mem::allocator::free(a);
+        a = old;
+    }
+}
+
+template<typename T, size_t Size, size_t Align> bool chaselev<T, Size, Align>::push(T in) {
+    int64_t b = tail.load(std::memory_order_relaxed);
+    int64_t t = head.load(std::memory_order_acquire);
+    node*   a = array.load(std::memory_order_relaxed);
+
+    if(!a) {
+        return false;
+    }
+
+    // full: grow, copy live range
+    if(b - t > int64_t(a->mask)) {
+        node* grown = create((a->mask + 1) << 1);
+        if(!grown) {
+            return false;
+        }
+        for(int64_t i = t; i < b; ++i) {
+            grown->put(i, a->get(i));
+        }
+        grown->retired = a;
+        array.store(grown, std::memory_order_release);
+        a = grown;
+    }
+
+    a->put(b, in);
+    std::atomic_thread_fence(std::memory_order_release);
+    tail.store(b + 1, std::memory_order_relaxed);
+    return true;
+}
+
+template<typename T, size_t Size, size_t Align> bool chaselev<T, Size, Align>::take(T* out) {
+    int64_t b = tail.load(std::memory_order_relaxed) - 1;
+    node*   a = array.load(std::memory_order_relaxed);
+    tail.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = head.load(std::memory_order_relaxed);
+
+    // empty
+    if(t > b) {
+        tail.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    *out = a->get(b);
+
+    // last one: race with thieves
+    if(t == b) {
+        bool won = head.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        tail.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+template<typename T, size_t Size, size_t Align> bool chaselev<T, Size, Align>::steal(T* out) {
+    int64_t t = head.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = tail.load(std::memory_order_acquire);
+
+    if(t >= b) {
+        return false;
+    }
+
+    node* a = array.load(std::memory_order_acquire);
+    T     x = a->get(t);
+    if(!head.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return false; // lost race
+    }
+    *out = x;
+    return true;
+}
+
+template<typename T, size_t Size, size_t Align> size_t chaselev<T, Size, Align>::size() const {
+    int64_t b = tail.load(std::memory_order_relaxed);
+    int64_t t = head.load(std::memory_order_relaxed);
+    return b > t ? size_t(b - t) : 0;
+}
+
+template<typename T, size_t Size, size_t Align> auto chaselev<T, Size, Align>::create(size_t capacity) -> node* {
+    mem::account::scope internal(mem::account::NONE);
+
+    node* ptr = static_cast<node*>(mem::allocator::malloc(sizeof(node) + sizeof(std::atomic<T>) * capacity, Align));
+    if(ptr) {
+        ptr->mask    = capacity - 1;
+        ptr->retired = nullptr;
+        for(size_t i = 0; i < capacity; ++i) {
+            new(ptr->array() + i) std::atomic<T>();
+        }
+    }
+    return ptr;
+}
+
+} // namespace data
+} // namespace lwe
@@ -6,25 +6,28 @@
 //=============================================================================
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 
 //=============================================================================
 // C++ library
 //=============================================================================
+#include <mutex>
 #include <atomic>
+#include <thread>
+#include <vector>
 #include <utility>
+#include <algorithm>
 #include <unordered_set>
 
-//=============================================================================
-// thirdparty
-//=============================================================================
-#include "thirdparty/concurrentqueue/concurrentqueue.h"
-
 namespace lwe {
 namespace config {
 enum {
     DEF_ALIGN = sizeof(void*),
     DEF_CACHE = (sizeof(void*) * sizeof(void*)) << 1,
 };
+
+/// @brief address space reserved by file mapping: 4 GB in 64 bit, 256 MB in 32 bit
+constexpr size_t DEF_RESERVE = size_t(1) << (sizeof(void*) == 8 ? 32 : 28);
 } // namespace config
 } // namespace lwe
 #endif
\ No newline at end of file
@@ -0,0 +1,63 @@
+#ifndef LWE_CORO_HEADER
+#define LWE_CORO_HEADER
+
+#include "pool.hh"
+
+#include <new>
+
+namespace lwe {
+namespace coro {
+
+/*******************************************************************************
+ * coroutine frame allocation through size-classed pool
+ *
+ * size class
+ *  - MIN << 0, MIN << 1, ... , MAX: pool::statics<class, ALIGN>()
+ *  - over MAX: allocator::malloc
+ *
+ * how to use
+ *
+ * @code {.cpp}
+ *  struct task {
+ *      struct promise_type: lwe::coro::pooled_promise {
+ *          ...
+ *      };
+ *  };
+ * @endcode
+ *
+ * - frame is get from current thread pool when coroutine is created.
+ * - resume / destroy on other thread is safe:
+ *   release finds parent pool and pushes to its gc. (lock-free)
+ * - destroy after the creating thread ends is safe:
+ *   its pool leaves live frames to heir, freed with the last frame.
+ ******************************************************************************/
+struct pooled_promise {
+    enum {
+        MIN   = 64,
+        MAX   = 4096,
+        ALIGN = __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+    };
+
+public:
+    /// @brief frame allocation
+    /// @note  throw std::bad_alloc when failed, as global operator new
+    static void* operator new(size_t);
+
+public:
+    /// @brief frame deallocation, size is same as allocated
+    static void operator delete(void*, size_t) noexcept;
+
+private:
+    /// @brief find size class and get memory
+    template<size_t Class = MIN> static void* allocate(size_t) noexcept;
+
+private:
+    /// @brief find size class and return memory
+    template<size_t Class = MIN> static void deallocate(void*, size_t) noexcept;
+};
+
+} // namespace coro
+} // namespace lwe
+
+#include "coro.inl"
+#endif
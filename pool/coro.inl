@@ -0,0 +1,45 @@
+#include "coro.hh"
+
+namespace lwe {
+namespace coro {
+
+void* pooled_promise::operator new(size_t size) {
+    void* ptr = allocate(size);
+    if(!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void pooled_promise::operator delete(void* in, size_t size) noexcept {
+    if(in) {
+        deallocate(in, size);
+    }
+}
+
+template<size_t Class> void* pooled_promise::allocate(size_t size) noexcept {
+    if constexpr(Class > MAX) {
+        return mem::allocator::malloc(size, ALIGN);
+    } else {
+        if(size <= Class) {
+            return mem::pool::statics<Class, ALIGN>().construct();
+        }
+        return allocate<(Class << 1)>(size);
+    }
+}
+
+template<size_t Class> void pooled_promise::deallocate(void* in, size_t size) noexcept {
+    if constexpr(Class > MAX) {
+        mem::allocator::free(in);
+    } else {
+        if(size <= Class) {
+            // parent pool: statics of this thread may be destroyed
+            mem::pool::release(in);
+            return;
+        }
+        deallocate<(Class << 1)>(in, size);
+    }
+}
+
+} // namespace coro
+} // namespace lwe
@@ -2,6 +2,13 @@
 #define LWE_QUEUE_HEADER
 
 #include "allocator.hh"
+#include "simd.hh"
+
+#ifndef _WIN32
+#    include <cerrno>
+#    include <unistd.h>
+#    include <sys/uio.h>
+#endif
 
 namespace lwe {
 namespace data {
@@ -12,28 +19,174 @@ namespace data {
  * the created array is stored and reused by the allocator when destroyed.
  * the allocator itself uses a static object.
  *
- * NOTE: allocator cache is fixed to 'config::DEF_CACHE'
+ * node map: array of node pointers like std::deque, for O(1) index.
+ * ┌──────┬──────┬──────┬──────┬──────┐
+ * │      │ node │ node │ node │      │ << map, 'base' is first node
+ * └──────┴──┬───┴──────┴───┬──┴──────┘
+ *           └ head         └ tail
+ * index i: (first->head + i) / Size is node, % Size is offset.
+ * only first and last nodes are partial.
+ * heap map is allocated when second node is linked: single node deque has none.
+ *
+ * node cache
+ * - default: thread local allocator, 'Cache' is depth.
+ *   same node size and depth is shared by all deques in thread.
+ *   looked up per call: deque can be used by other thread, or after thread locals are destroyed.
+ * - node_cache: explicit cache, shared by deques given it.
+ *
+ * @code {.cpp}
+ *  deque<int, 64, 8, 1024> busy;  // deep cache for high churn
+ *  node_cache<int> small(4);      // shallow cache for idle queues
+ *  deque<int> a(small), b(small); // share
+ *  small.report();                // hits and misses
+ * @endcode
+ *
+ * inline first node
+ * - Inline: first node and small map are in deque object.
+ *   deque within one node never touches the allocator.
+ * - over it, heap nodes are linked, inline node is reused when unlinked.
+ *
+ * @code {.cpp}
+ *  deque<packet*, 16, 8, config::DEF_CACHE, true> sends; // per connection
+ * @endcode
+ *
+ * search and reduction
+ * - find / count_if / sum / min / max run util::simd kernels per node array.
+ * - segments(): contiguous arrays of range, for own kernels.
+ *
+ * stream (POSIX)
+ * - write_to / read_from: node arrays are iovec of writev / readv, no staging.
+ * - T must be trivially copyable, byte order and layout are of this machine.
+ * - short read in element: its bytes are kept in remainder of caller, not in deque.
+ *
+ * @code {.cpp}
+ *  deque<record>::remainder rest; // per stream
+ *  while(in.read_from(fd, 64, &rest)) { ... }
+ * @endcode
+ *
+ * NOTE: node_cache is not thread-safe, share in same thread.
  ******************************************************************************/
-template<typename T, size_t Size = config::DEF_CACHE, size_t Align = config::DEF_ALIGN> class deque {
-    struct node;
+template<typename T, size_t Size, size_t Align> class node_cache;
+
+template<typename T,
+         size_t Size  = config::DEF_CACHE,
+         size_t Align = config::DEF_ALIGN,
+         size_t Cache = config::DEF_CACHE,
+         bool   Inline = false>
+class deque {
+    struct node {
+        /// @brief union for ignore calls to constructor and destructor
+        union {
+            T       array[Size];
+            uint8_t serialized[sizeof(T) * Size];
+        };
+
+        node*  next;
+        node*  prev;
+        size_t head;
+        size_t tail;
+    };
+
+private:
+    template<typename, size_t, size_t> friend class node_cache;
+
+private:
+    /// @brief random access iterator by index
+    template<bool Const> class cursor;
 
 public:
+    using iterator       = cursor<false>;
+    using const_iterator = cursor<true>;
+
+public:
+    /// @brief use thread local node cache
     deque();
+
+public:
+    /// @brief use shared node cache, it must outlive deque
+    explicit deque(node_cache<T, Size, Align>&);
+
+public:
     ~deque();
 
+public:
+    /// @brief nodes are owned, inline node and map are pointed to by self
+    deque(const deque&)            = delete;
+    deque(deque&&)                 = delete;
+    deque& operator=(const deque&) = delete;
+    deque& operator=(deque&&)      = delete;
+
 public:
     /// @brief push back
     template<typename Arg> bool push(Arg&&);
 
+public:
+    /// @brief construct in place at back
+    template<typename... Args> bool emplace_back(Args&&...);
+
+public:
+    /// @brief push front, new node is filled from its tail
+    template<typename Arg> bool push_front(Arg&&);
+
+public:
+    /// @brief construct in place at front
+    template<typename... Args> bool emplace_front(Args&&...);
+
+public:
+    /// @brief push back n elements, copy by node segment (memcpy if trivially copyable)
+    /// @return false: failed to allocate, nothing is pushed
+    bool push_range(const T*, size_t);
+
+public:
+    /// @brief pop front n elements to out, by node segment
+    /// @return popped count, less than n at empty
+    size_t pop_front_n(T*, size_t);
+
+public:
+    /// @brief pop back n elements to out, by node segment
+    /// @note   order is kept: out[0] is the frontmost popped element
+    /// @return popped count, less than n at empty
+    size_t pop_back_n(T*, size_t);
+
+public:
+    /// @brief visit [from, to) by node segment: fn(T* ptr, size_t n)
+    /// @note  to is clamped to size()
+    template<typename F> void segments(size_t from, size_t to, F&& fn);
+
+public:
+    /// @brief visit [from, to) by node segment: fn(const T* ptr, size_t n)
+    template<typename F> void segments(size_t from, size_t to, F&& fn) const;
+
+public:
+    /// @brief  first index of element (op) value at or after 'from', SIMD by node
+    /// @return size(): not found
+    size_t find(const T&, util::simd::cmp = util::simd::E_EQ, size_t from = 0) const;
+
+public:
+    /// @brief count of element (op) value in [from, to), SIMD by node
+    size_t count_if(const T&, util::simd::cmp = util::simd::E_EQ, size_t from = 0, size_t to = size_t(-1)) const;
+
+public:
+    /// @brief reduction of [from, to), SIMD by node
+    /// @note  T() when range is empty
+    T sum(size_t from = 0, size_t to = size_t(-1)) const;
+    T min(size_t from = 0, size_t to = size_t(-1)) const;
+    T max(size_t from = 0, size_t to = size_t(-1)) const;
+
+public:
+    /// @brief pre-allocate nodes, push of n elements does not allocate
+    /// @return false: failed to allocate
+    bool reserve(size_t);
+
 public:
     /// @brief pop_front
-    /// @param  [out] nullptr: not get, call destructor
+    /// @param  [out] nullptr: not get, call destructor. else moved to, then destructor
     /// @return false: at empty
     bool fifo(T* = nullptr);
 
 public:
     /// @brief pop_back
-    /// @param  [out] nullptr: not get, call destructor
+    /// @param  [out] nullptr: not get, call destructor. else moved to, then destructor
     /// @return false: at empty
     bool lifo(T* = nullptr);
 
@@ -47,13 +200,81 @@ public:
     /// @note  safe: not reallocate
     T* top() const;
 
+public:
+    /// @brief O(1) index from front, not checked
+    T& operator[](size_t);
+
+public:
+    /// @brief O(1) index from front, not checked
+    const T& operator[](size_t) const;
+
+public:
+    iterator       begin();
+    iterator       end();
+    const_iterator begin() const;
+    const_iterator end() const;
+
 private:
     /// @brief actual delete (fifo / lifo)
     bool pop(T* in, T* out);
 
 private:
-    /// @brief allocate
-    static node* create();
+    /// @brief allocate, inline node first
+    node* create();
+
+private:
+    /// @brief deallocate, inline node is kept
+    void remove(node*);
+
+private:
+    /// @brief map is inline table
+    bool inlined() const;
+
+private:
+    /// @brief node of map index from first, first when map is not allocated yet
+    node* locate(size_t) const;
+
+private:
+    /// @brief link new node at back, spare first
+    bool grow();
+
+private:
+    /// @brief link new node at front, spare first
+    bool grow_front();
+
+private:
+    /// @brief free empty front node and move to next
+    void shift();
+
+private:
+    /// @brief free empty back node and move to previous
+    void unshift();
+
+#ifndef _WIN32
+public:
+    /// @brief  write all elements to fd by node array: writev
+    /// @note   partial write is continued, stops on error or 0 written
+    /// @return written bytes, less than size() * sizeof(T) when stopped
+    size_t write_to(int fd) const;
+
+public:
+    /// @brief incomplete element of read_from, kept by caller per stream
+    struct remainder {
+        uint8_t bytes[sizeof(T)];
+        size_t  size = 0; // 0: stream is at element boundary
+    };
+
+public:
+    /// @brief  append up to n elements from fd into node arrays: readv
+    /// @param  [in,out] rest - incomplete element, completed by next read with it
+    /// @note   stops at EOF or error. rest is nullptr: incomplete element is dropped
+    /// @return appended element count
+    size_t read_from(int fd, size_t n, remainder* rest = nullptr);
+
+private:
+    /// @brief readv / writev until all of iovec, false when stopped
+    static bool transfer(int fd, iovec*, int count, bool write, size_t* bytes);
+#endif
 
 public:
     /// @brief current size, useable like bool type
@@ -67,8 +288,57 @@ private:
     size_t capacity;
 
 private:
-    /// @brief thread-safe allocator
-    static mem::allocator& heap;
+    /// @brief reserved nodes, singly linked by next
+    node* spare = nullptr;
+
+private:
+    /// @brief make room in map
+    /// @param [in] front - true: before first, false: after last
+    /// @param [in] count - node slots to make room for
+    bool place(bool front, size_t count = 1);
+
+private:
+    node** map   = nullptr;
+    size_t slots = 0; // map capacity
+    size_t base  = 0; // map index of first
+    size_t nodes = 0; // node count in map
+
+public:
+    /// @brief hits and misses of node cache in use
+    mem::allocator::stats report() const;
+
+private:
+    deque(mem::allocator*);
+
+private:
+    /// @brief node allocator: shared, else thread local
+    /// @return nullptr: thread local is destroyed at thread end, not cached
+    mem::allocator* heap() const;
+
+private:
+    /// @brief node bytes as allocated by node cache, for uncached malloc / free
+    static constexpr size_t NODE = util::aligner::padding(sizeof(node), util::aligner::boundary(Align));
+
+private:
+    mem::allocator* shared = nullptr;
+
+private:
+    /// @brief inline first node and map, empty when not Inline
+    struct embedded {
+        alignas(node) uint8_t storage[sizeof(node)];
+        node*                 table[4];
+        bool                  used;
+    };
+    struct nothing {};
+    std::conditional_t<Inline, embedded, nothing> local;
+};
+
+/// @brief node cache for deques of same T, Size and Align
+template<typename T, size_t Size = config::DEF_CACHE, size_t Align = config::DEF_ALIGN>
+class node_cache: public mem::allocator {
+public:
+    /// @param [in] depth - cached node count
+    node_cache(size_t depth = config::DEF_CACHE) noexcept;
 };
 
 } // namespace data
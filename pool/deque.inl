@@ -3,32 +3,90 @@
 namespace lwe {
 namespace data {
 
-template<typename T, size_t Size, size_t Align>
-mem::allocator& deque<T, Size, Align>::heap =
-    mem::allocator::statics<sizeof(node), util::aligner::boundary(Align), config::DEF_CACHE>();
-
-template<typename T, size_t Size, size_t Align> struct deque<T, Size, Align>::node {
-    /// @brief union for ignore calls to constructor and destructor
-    union {
-        T       array[Size];
-        uint8_t serialized[sizeof(T) * Size];
-    };
-
-    node*  next;
-    node*  prev;
-    size_t head;
-    size_t tail;
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> template<bool Const> class deque<T, Size, Align, Cache, Inline>::cursor {
+    using owner = std::conditional_t<Const, const deque, deque>;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = T;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = std::conditional_t<Const, const T*, T*>;
+    using reference         = std::conditional_t<Const, const T&, T&>;
+
+public:
+    cursor() = default;
+    cursor(owner* in, size_t at): self(in), index(at) {}
+    operator cursor<true>() const { return { self, index }; }
+
+public:
+    reference operator*() const { return (*self)[index]; }
+    pointer   operator->() const { return &(*self)[index]; }
+    reference operator[](difference_type n) const { return (*self)[index + n]; }
+
+public:
+    cursor& operator++() { ++index; return *this; }
+    cursor& operator--() { --index; return *this; }
+    cursor  operator++(int) { cursor out = *this; ++index; return out; }
+    cursor  operator--(int) { cursor out = *this; --index; return out; }
+    cursor& operator+=(difference_type n) { index += n; return *this; }
+    cursor& operator-=(difference_type n) { index -= n; return *this; }
+
+public:
+    cursor          operator+(difference_type n) const { return { self, index + n }; }
+    cursor          operator-(difference_type n) const { return { self, index - n }; }
+    difference_type operator-(const cursor& in) const { return difference_type(index) - difference_type(in.index); }
+    friend cursor   operator+(difference_type n, const cursor& in) { return in + n; }
+
+public:
+    bool operator==(const cursor& in) const { return index == in.index; }
+    bool operator!=(const cursor& in) const { return index != in.index; }
+    bool operator<(const cursor& in) const { return index < in.index; }
+    bool operator>(const cursor& in) const { return index > in.index; }
+    bool operator<=(const cursor& in) const { return index <= in.index; }
+    bool operator>=(const cursor& in) const { return index >= in.index; }
+
+private:
+    owner* self  = nullptr;
+    size_t index = 0;
 };
 
-template<typename T, size_t Size, size_t Align> deque<T, Size, Align>::deque() {
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline>
+deque<T, Size, Align, Cache, Inline>::deque(): deque(nullptr) {}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline>
+deque<T, Size, Align, Cache, Inline>::deque(node_cache<T, Size, Align>& in): deque(static_cast<mem::allocator*>(&in)) {}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline>
+deque<T, Size, Align, Cache, Inline>::deque(mem::allocator* in): shared(in) {
+    if constexpr(Inline) {
+        local.used = false;
+        map        = local.table;
+        slots      = sizeof(local.table) / sizeof(node*);
+    }
+
+    count = 0;
     first = create();
     if(first) {
         capacity = Size;
     } else capacity = 0;
     last = first;
+
+    // heap map is allocated with second node: first is not in it until then
+    if(first) {
+        if(inlined()) {
+            map[base] = first;
+        }
+        nodes = 1;
+    }
 }
 
-template<typename T, size_t Size, size_t Align> deque<T, Size, Align>::~deque() {
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> deque<T, Size, Align, Cache, Inline>::~deque() {
+    while(spare != nullptr) {
+        node* temp = spare;
+        spare      = spare->next;
+        remove(temp);
+    }
+
     while(first != nullptr) {
         for(size_t i = first->head; i < first->tail; ++i) {
             first->array[i].~T();
@@ -36,29 +94,410 @@ template<typename T, size_t Size, size_t Align> deque<T, Size, Align>::~deque()
 
         node* temp = first;
         first      = first->next;
-        heap.deallocate(temp);
+        remove(temp);
+    }
+
+    if(!inlined()) {
+        mem::allocator::free(map);
     }
 }
 
-template<typename T, size_t Size, size_t Align> template<typename Arg> bool deque<T, Size, Align>::push(Arg&& in) {
-    if(last->tail == Size) {
-        last->next = create();
-        if(last->next) {
-            last->next->prev = last;
-            last             = last->next;
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> template<typename Arg> bool deque<T, Size, Align, Cache, Inline>::push(Arg&& in) {
+    return emplace_back(std::forward<Arg>(in));
+}
 
-            capacity += Size;
-        } else return false;
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline>
+template<typename... Args>
+bool deque<T, Size, Align, Cache, Inline>::emplace_back(Args&&... args) {
+    if(last->tail == Size && !grow()) {
+        return false;
     }
 
-    last->array[last->tail] = std::forward<Arg>(in);
+    // raw storage: construct, not assign
+    new(last->array + last->tail) T(std::forward<Args>(args)...);
 
     ++last->tail;
     ++count;
     return true;
 }
 
-template<typename T, size_t Size, size_t Align> bool deque<T, Size, Align>::fifo(T* out) {
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> template<typename Arg> bool deque<T, Size, Align, Cache, Inline>::push_front(Arg&& in) {
+    return emplace_front(std::forward<Arg>(in));
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline>
+template<typename... Args>
+bool deque<T, Size, Align, Cache, Inline>::emplace_front(Args&&... args) {
+    if(first->head == 0) {
+        // empty: reuse node from its tail
+        if(count == 0) {
+            first->head = Size;
+            first->tail = Size;
+        } else if(!grow_front()) {
+            return false;
+        }
+    }
+
+    new(first->array + (first->head - 1)) T(std::forward<Args>(args)...);
+
+    --first->head;
+    ++count;
+    return true;
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> bool deque<T, Size, Align, Cache, Inline>::push_range(const T* in, size_t n) {
+    if(!reserve(n)) {
+        return false;
+    }
+
+    for(size_t i = 0; i < n;) {
+        if(last->tail == Size) {
+            grow(); // reserved
+        }
+
+        size_t size = Size - last->tail;
+        if(size > n - i) {
+            size = n - i;
+        }
+
+        T* dst = last->array + last->tail;
+        if constexpr(std::is_trivially_copyable_v<T>) {
+            std::memcpy(static_cast<void*>(dst), in + i, sizeof(T) * size);
+        } else {
+            for(size_t j = 0; j < size; ++j) {
+                new(dst + j) T(in[i + j]);
+            }
+        }
+
+        last->tail += size;
+        count      += size;
+        i          += size;
+    }
+    return true;
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> size_t deque<T, Size, Align, Cache, Inline>::pop_front_n(T* out, size_t n) {
+    if(n > count) {
+        n = count;
+    }
+
+    for(size_t i = 0; i < n;) {
+        size_t size = first->tail - first->head;
+        if(size > n - i) {
+            size = n - i;
+        }
+
+        T* src = first->array + first->head;
+        if constexpr(std::is_trivially_copyable_v<T>) {
+            std::memcpy(static_cast<void*>(out + i), src, sizeof(T) * size);
+        } else {
+            for(size_t j = 0; j < size; ++j) {
+                out[i + j] = std::move(src[j]);
+                src[j].~T();
+            }
+        }
+
+        first->head += size;
+        count       -= size;
+        i           += size;
+
+        if(count == 0) {
+            first->head = 0;
+            first->tail = 0;
+        } else if(first->head == Size) {
+            shift();
+        }
+    }
+    return n;
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> size_t deque<T, Size, Align, Cache, Inline>::pop_back_n(T* out, size_t n) {
+    if(n > count) {
+        n = count;
+    }
+
+    // fill from the end of out
+    for(size_t i = n; i > 0;) {
+        size_t size = last->tail - last->head;
+        if(size > i) {
+            size = i;
+        }
+
+        T* src = last->array + (last->tail - size);
+        T* dst = out + (i - size);
+        if constexpr(std::is_trivially_copyable_v<T>) {
+            std::memcpy(static_cast<void*>(dst), src, sizeof(T) * size);
+        } else {
+            for(size_t j = 0; j < size; ++j) {
+                dst[j] = std::move(src[j]);
+                src[j].~T();
+            }
+        }
+
+        last->tail -= size;
+        count      -= size;
+        i          -= size;
+
+        if(count == 0) {
+            first->head = 0;
+            first->tail = 0;
+        } else if(last->tail == 0) {
+            unshift();
+        }
+    }
+    return n;
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline>
+template<typename F>
+void deque<T, Size, Align, Cache, Inline>::segments(size_t from, size_t to, F&& fn) {
+    if(to > count) {
+        to = count;
+    }
+
+    // only first and last nodes are partial: map index is position / Size
+    size_t at  = first ? first->head + from : 0;
+    size_t end = first ? first->head + to : 0;
+    while(at < end) {
+        size_t offset = at % Size;
+        size_t size   = Size - offset < end - at ? Size - offset : end - at;
+        fn(locate(at / Size)->array + offset, size);
+        at += size;
+    }
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline>
+template<typename F>
+void deque<T, Size, Align, Cache, Inline>::segments(size_t from, size_t to, F&& fn) const {
+    const_cast<deque*>(this)->segments(from, to, [&fn](T* ptr, size_t n) { fn(static_cast<const T*>(ptr), n); });
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline>
+size_t deque<T, Size, Align, Cache, Inline>::find(const T& value, util::simd::cmp op, size_t from) const {
+    size_t out = count;
+    size_t at  = from;
+    segments(from, count, [&](const T* ptr, size_t n) {
+        if(out == count) {
+            size_t index = util::simd::find(ptr, n, value, op);
+            if(index < n) {
+                out = at + index;
+            }
+            at += n;
+        }
+    });
+    return out;
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline>
+size_t deque<T, Size, Align, Cache, Inline>::count_if(const T& value, util::simd::cmp op, size_t from, size_t to) const {
+    size_t out = 0;
+    segments(from, to, [&](const T* ptr, size_t n) { out += util::simd::count(ptr, n, value, op); });
+    return out;
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline>
+T deque<T, Size, Align, Cache, Inline>::sum(size_t from, size_t to) const {
+    T out = T();
+    segments(from, to, [&](const T* ptr, size_t n) { out += util::simd::sum(ptr, n); });
+    return out;
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline>
+T deque<T, Size, Align, Cache, Inline>::min(size_t from, size_t to) const {
+    T    out   = T();
+    bool empty = true;
+    segments(from, to, [&](const T* ptr, size_t n) {
+        T value = util::simd::min(ptr, n);
+        if(empty || value < out) {
+            out   = value;
+            empty = false;
+        }
+    });
+    return out;
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline>
+T deque<T, Size, Align, Cache, Inline>::max(size_t from, size_t to) const {
+    T    out   = T();
+    bool empty = true;
+    segments(from, to, [&](const T* ptr, size_t n) {
+        T value = util::simd::max(ptr, n);
+        if(empty || out < value) {
+            out   = value;
+            empty = false;
+        }
+    });
+    return out;
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> bool deque<T, Size, Align, Cache, Inline>::reserve(size_t n) {
+    size_t room = last ? Size - last->tail : 0;
+    size_t more = room < n ? (n - room + Size - 1) / Size : 0;
+    if(more && !place(false, more)) {
+        return false; // map room too: grow does not allocate
+    }
+
+    for(node* i = spare; i && room < n; i = i->next) {
+        room += Size;
+    }
+
+    while(room < n) {
+        node* ptr = create();
+        if(!ptr) {
+            return false;
+        }
+        ptr->next = spare;
+        spare     = ptr;
+        room     += Size;
+    }
+    return true;
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> bool deque<T, Size, Align, Cache, Inline>::grow() {
+    if(!place(false)) {
+        return false;
+    }
+
+    node* ptr = spare;
+    if(ptr) {
+        spare     = ptr->next;
+        ptr->next = nullptr;
+    } else {
+        ptr = create();
+        if(!ptr) {
+            return false;
+        }
+    }
+
+    ptr->prev  = last;
+    last->next = ptr;
+    last       = ptr;
+    capacity  += Size;
+
+    map[base + nodes++] = ptr;
+    return true;
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> bool deque<T, Size, Align, Cache, Inline>::grow_front() {
+    if(!place(true)) {
+        return false;
+    }
+
+    node* ptr = spare;
+    if(ptr) {
+        spare     = ptr->next;
+        ptr->next = nullptr;
+    } else {
+        ptr = create();
+        if(!ptr) {
+            return false;
+        }
+    }
+
+    ptr->head   = Size;
+    ptr->tail   = Size;
+    ptr->next   = first;
+    first->prev = ptr;
+    first       = ptr;
+    capacity   += Size;
+
+    map[--base] = ptr;
+    ++nodes;
+    return true;
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> bool deque<T, Size, Align, Cache, Inline>::place(bool front, size_t count) {
+    if(front ? base >= count : base + nodes + count <= slots) {
+        return true;
+    }
+
+    // half empty: center, else double
+    size_t size = slots;
+    if((nodes + count) * 2 > slots) {
+        size = slots ? slots << 1 : 8;
+        while(size < (nodes + count) * 2) {
+            size <<= 1;
+        }
+    }
+    size_t from = (size - nodes) >> 1;
+    if(front && from == 0) {
+        from = 1;
+    }
+
+    node** dst = map;
+    if(size != slots) {
+        mem::account::scope internal(mem::account::NONE);
+        dst = static_cast<node**>(mem::allocator::malloc(sizeof(node*) * size));
+        if(!dst) {
+            return false;
+        }
+    }
+    if(nodes && map) {
+        std::memmove(dst + from, map + base, sizeof(node*) * nodes);
+    } else if(nodes) {
+        dst[from] = first; // lazy: first only
+    }
+    if(dst != map) {
+        if(!inlined()) {
+            mem::allocator::free(map);
+        }
+        map   = dst;
+        slots = size;
+    }
+    base = from;
+    return true;
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> T& deque<T, Size, Align, Cache, Inline>::operator[](size_t index) {
+    size_t at = first->head + index;
+    return locate(at / Size)->array[at % Size];
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> const T& deque<T, Size, Align, Cache, Inline>::operator[](size_t index) const {
+    size_t at = first->head + index;
+    return locate(at / Size)->array[at % Size];
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> auto deque<T, Size, Align, Cache, Inline>::begin() -> iterator {
+    return { this, 0 };
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> auto deque<T, Size, Align, Cache, Inline>::end() -> iterator {
+    return { this, count };
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> auto deque<T, Size, Align, Cache, Inline>::begin() const -> const_iterator {
+    return { this, 0 };
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> auto deque<T, Size, Align, Cache, Inline>::end() const -> const_iterator {
+    return { this, count };
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> void deque<T, Size, Align, Cache, Inline>::shift() {
+    if(first->next) {
+        capacity -= Size;
+        first     = first->next;
+        remove(first->prev);
+        first->prev = nullptr;
+
+        ++base;
+        --nodes;
+    }
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> void deque<T, Size, Align, Cache, Inline>::unshift() {
+    if(last->prev) {
+        capacity -= Size;
+        last      = last->prev;
+        remove(last->next);
+        last->next = nullptr;
+
+        --nodes;
+    }
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> bool deque<T, Size, Align, Cache, Inline>::fifo(T* out) {
     // false: at empty
     if(!pop(front(), out)) {
         return false;
@@ -71,18 +510,12 @@ template<typename T, size_t Size, size_t Align> bool deque<T, Size, Align>::fifo
 
     // node is empty: free node and move to next
     if(++first->head == Size) {
-        // next
-        if(first->next) {
-            capacity -= Size;
-            first     = first->next;
-            heap.deallocate(first->prev);
-            first->prev = nullptr;
-        }
+        shift();
     }
     return true;
 }
 
-template<typename T, size_t Size, size_t Align> bool deque<T, Size, Align>::lifo(T* out) {
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> bool deque<T, Size, Align, Cache, Inline>::lifo(T* out) {
     if(!pop(top(), out)) {
         return false;
     }
@@ -94,39 +527,35 @@ template<typename T, size_t Size, size_t Align> bool deque<T, Size, Align>::lifo
 
     // node is empty: free node and move to previous
     if(--last->tail == 0) {
-        if(last->prev) {
-            capacity -= Size;
-            last      = last->prev;
-            heap.deallocate(last->next);
-            last->next = nullptr;
-        }
+        unshift();
     }
     return true;
 }
 
-template<typename T, size_t Size, size_t Align> T* deque<T, Size, Align>::front() const {
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> T* deque<T, Size, Align, Cache, Inline>::front() const {
     if(count) {
         return first->array + first->head;
     }
     return nullptr;
 }
 
-template<typename T, size_t Size, size_t Align> T* deque<T, Size, Align>::top() const {
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> T* deque<T, Size, Align, Cache, Inline>::top() const {
     if(count) {
         return last->array + (last->tail - 1);
     }
     return nullptr;
 }
 
-template<typename T, size_t Size, size_t Align> inline bool deque<T, Size, Align>::pop(T* in, T* out) {
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> inline bool deque<T, Size, Align, Cache, Inline>::pop(T* in, T* out) {
     if(count == 0) {
         return false;
     }
 
-    // return;
+    // return: move, not copy
     if(out) {
-        *out = *in;
-    } else in->~T();
+        *out = std::move(*in);
+    }
+    in->~T();
 
     // if last node than recycle
     if(--count == 0) {
@@ -136,8 +565,22 @@ template<typename T, size_t Size, size_t Align> inline bool deque<T, Size, Align
     return true;
 }
 
-template<typename T, size_t Size, size_t Align> auto deque<T, Size, Align>::create() -> node* {
-    node* ptr = static_cast<node*>(heap.allocate());
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> auto deque<T, Size, Align, Cache, Inline>::create() -> node* {
+    node* ptr = nullptr;
+    if constexpr(Inline) {
+        if(!local.used) {
+            local.used = true;
+            ptr        = reinterpret_cast<node*>(local.storage);
+        }
+    }
+    if(!ptr) {
+        if(mem::allocator* from = heap()) {
+            ptr = static_cast<node*>(from->allocate());
+        } else {
+            mem::account::scope internal(mem::account::NONE);
+            ptr = static_cast<node*>(mem::allocator::malloc(NODE, util::aligner::boundary(Align)));
+        }
+    }
     if(ptr) {
         ptr->head = 0;
         ptr->tail = 0;
@@ -147,9 +590,203 @@ template<typename T, size_t Size, size_t Align> auto deque<T, Size, Align>::crea
     return ptr;
 }
 
-template<typename T, size_t Size, size_t Align> size_t deque<T, Size, Align>::size() const {
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> void deque<T, Size, Align, Cache, Inline>::remove(node* in) {
+    if constexpr(Inline) {
+        if(in == reinterpret_cast<node*>(local.storage)) {
+            local.used = false;
+            return;
+        }
+    }
+    if(mem::allocator* from = heap()) {
+        from->deallocate(in);
+    } else {
+        mem::account::scope internal(mem::account::NONE);
+        mem::allocator::free(in);
+    }
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> auto deque<T, Size, Align, Cache, Inline>::locate(size_t index) const -> node* {
+    return map ? map[base + index] : first;
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> bool deque<T, Size, Align, Cache, Inline>::inlined() const {
+    if constexpr(Inline) {
+        return map == local.table;
+    }
+    return false;
+}
+
+#ifndef _WIN32
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline>
+size_t deque<T, Size, Align, Cache, Inline>::write_to(int fd) const {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+    enum { BATCH = 64 };
+    iovec  vec[BATCH];
+    int    used  = 0;
+    size_t bytes = 0;
+    bool   alive = true;
+
+    segments(0, count, [&](const T* ptr, size_t n) {
+        if(!alive) {
+            return;
+        }
+        vec[used].iov_base = const_cast<T*>(ptr);
+        vec[used].iov_len  = n * sizeof(T);
+        if(++used == BATCH) {
+            alive = transfer(fd, vec, used, true, &bytes);
+            used  = 0;
+        }
+    });
+
+    if(alive && used) {
+        transfer(fd, vec, used, true, &bytes);
+    }
+    return bytes;
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline>
+size_t deque<T, Size, Align, Cache, Inline>::read_from(int fd, size_t n, remainder* rest) {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+    if(!last || n == 0) {
+        return 0;
+    }
+
+    // link nodes first: read into place, no copy
+    node*  from = last;
+    size_t room = Size - last->tail;
+    while(room < n && grow()) {
+        room += Size;
+    }
+    if(room < n) {
+        n = room;
+    }
+    if(n == 0) {
+        return 0;
+    }
+
+    enum { BATCH = 64 };
+    iovec  vec[BATCH];
+    int    used  = 0;
+    size_t bytes = 0;
+    bool   alive = true;
+
+    // incomplete element of last read is first
+    size_t carried = rest ? rest->size : 0;
+    size_t skip    = carried;
+    size_t left = n;
+    for(node* i = from; i && left && alive; i = i->next) {
+        size_t size = Size - i->tail < left ? Size - i->tail : left;
+        if(size == 0) {
+            continue;
+        }
+        uint8_t* ptr = reinterpret_cast<uint8_t*>(i->array + i->tail);
+        if(skip) {
+            std::memcpy(ptr, rest->bytes, skip);
+        }
+
+        vec[used].iov_base = ptr + skip;
+        vec[used].iov_len  = size * sizeof(T) - skip;
+        left              -= size;
+        skip               = 0;
+        if(++used == BATCH || left == 0) {
+            alive = transfer(fd, vec, used, false, &bytes);
+            used  = 0;
+        }
+    }
+
+    // commit complete elements
+    size_t total = carried + bytes;
+    size_t got   = total / sizeof(T);
+    node*  at    = from;
+    left         = got;
+    while(true) {
+        while(at && at->tail == Size) {
+            at = at->next;
+        }
+        if(!left) {
+            break;
+        }
+        size_t size = Size - at->tail < left ? Size - at->tail : left;
+        at->tail   += size;
+        left       -= size;
+    }
+    count += got;
+
+    // incomplete element: kept for next read, its node can be spared below
+    if(rest) {
+        rest->size = total % sizeof(T);
+        if(rest->size) {
+            std::memcpy(rest->bytes, at->array + at->tail, rest->size);
+        }
+    }
+
+    // not filled nodes to spare
+    while(last != from && last->tail == 0) {
+        node* ptr  = last;
+        last       = last->prev;
+        last->next = nullptr;
+        capacity  -= Size;
+        --nodes;
+
+        ptr->next = spare;
+        ptr->prev = nullptr;
+        spare     = ptr;
+    }
+    return got;
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline>
+bool deque<T, Size, Align, Cache, Inline>::transfer(int fd, iovec* vec, int count, bool write, size_t* bytes) {
+    int at = 0;
+    while(at < count) {
+        ssize_t got = write ? ::writev(fd, vec + at, count - at) : ::readv(fd, vec + at, count - at);
+        if(got < 0 && errno == EINTR) {
+            continue;
+        }
+        if(got <= 0) {
+            return false;
+        }
+        *bytes += got;
+
+        // partial: skip done, continue in the middle
+        size_t done = got;
+        while(at < count && done >= vec[at].iov_len) {
+            done -= vec[at].iov_len;
+            ++at;
+        }
+        if(at < count) {
+            vec[at].iov_base  = static_cast<uint8_t*>(vec[at].iov_base) + done;
+            vec[at].iov_len  -= done;
+        }
+    }
+    return true;
+}
+#endif
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> size_t deque<T, Size, Align, Cache, Inline>::size() const {
     return count;
 }
 
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline>
+mem::allocator::stats deque<T, Size, Align, Cache, Inline>::report() const {
+    if(mem::allocator* from = heap()) {
+        return from->report();
+    }
+    return {};
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline> mem::allocator* deque<T, Size, Align, Cache, Inline>::heap() const {
+    if(shared) {
+        return shared;
+    }
+    return mem::allocator::statics<sizeof(node), util::aligner::boundary(Align), Cache>();
+}
+
+template<typename T, size_t Size, size_t Align>
+node_cache<T, Size, Align>::node_cache(size_t depth) noexcept:
+    mem::allocator(sizeof(typename deque<T, Size, Align>::node), util::aligner::boundary(Align), depth) {}
+
 } // namespace data
 } // namespace lwe
\ No newline at end of file
@@ -0,0 +1,140 @@
+#ifndef LWE_EPOCH_HEADER
+#define LWE_EPOCH_HEADER
+
+#include "pool.hh"
+
+#include <vector>
+
+namespace lwe {
+namespace mem {
+
+/*******************************************************************************
+ * epoch based reclamation for pooled objects
+ *
+ * global epoch: e
+ * ├─ thread enter(): announce e, active
+ * ├─ retire(ptr) : queued with e
+ * └─ advance     : e + 1 when every active thread announced e
+ *
+ * object retired at e is not reachable by any reader at e + 2:
+ * destructor is called, and chunks go back to parent pools in batch.
+ * (pool::release: same parent run is one bulk enqueue to its gc)
+ *
+ * how to use
+ *
+ * @code {.cpp}
+ *  epoch& domain = epoch::global();
+ *  {
+ *      epoch::guard lock(domain); // read section
+ *      node* n = head.load();
+ *      ...
+ *  }
+ *  domain.retire(old);            // old is from pool
+ * @endcode
+ *
+ * - enter / leave is nestable, one store each at outer.
+ * - retired list is per thread: collected every 'batch' retire, or collect().
+ * - safe objects are collected when thread ends, rest by other thread.
+ * - chunk of pool of current thread is recycled at once, else by its gc.
+ * - parent pool destroyed before collect: chunks go to its heir.
+ * - domain destroyed before threads end: their records are deleted at thread end.
+ *
+ * NOTE: retire only pointer from pool. no thread may use or end while domain is destroyed.
+ ******************************************************************************/
+class epoch {
+public:
+    epoch(const epoch&)            = delete;
+    epoch& operator=(const epoch&) = delete;
+    epoch(epoch&&)                 = delete;
+    epoch& operator=(epoch&&)      = delete;
+
+private:
+    /// @brief per thread state
+    struct record;
+
+private:
+    /// @brief thread local records of all domains, orphaned when thread ends
+    struct holder;
+
+private:
+    /// @brief retired object
+    struct item {
+        void*  ptr;
+        void   (*destroy)(void*);
+        size_t at;
+    };
+
+public:
+    /// @brief RAII read section
+    class guard {
+    public:
+        guard(epoch& in) noexcept: domain(in) { domain.enter(); }
+        ~guard() noexcept { domain.leave(); }
+
+    private:
+        epoch& domain;
+    };
+
+public:
+    /// @param [in] batch - retired count per thread to try collect.
+    epoch(size_t batch = config::DEF_CACHE) noexcept;
+
+public:
+    /// @brief destroy all retired objects
+    ~epoch() noexcept;
+
+public:
+    /// @brief process wide domain
+    static epoch& global() noexcept;
+
+public:
+    /// @brief begin read section
+    void enter() noexcept;
+
+public:
+    /// @brief end read section
+    void leave() noexcept;
+
+public:
+    /// @brief destroy and return to pool after no reader can hold it
+    /// @note  not queued (out of memory): collect, else wait other readers and return now
+    template<typename T> void retire(T*) noexcept;
+
+public:
+    /// @brief try advance, destroy safe objects of current thread and ended threads
+    /// @return returned chunk count
+    size_t collect() noexcept;
+
+private:
+    /// @brief record of current thread, create when not exist
+    record* local() noexcept;
+
+private:
+    /// @brief epoch + 1 when all active threads are in current
+    /// @param [in] skip - record not waited: retiring thread does not read it again
+    bool advance(const record* skip = nullptr) noexcept;
+
+private:
+    /// @brief destroy items retired before 'e - 1'
+    static size_t flush(record*, size_t) noexcept;
+
+private:
+    /// @brief call destructor only
+    template<typename T> static void destroy(void*) noexcept;
+
+private:
+    const size_t BATCH;
+
+private:
+    std::atomic<size_t> current;
+
+private:
+    std::mutex           lock;
+    std::vector<record*> records;
+};
+
+} // namespace mem
+} // namespace lwe
+
+#include "epoch.inl"
+#endif
@@ -0,0 +1,196 @@
+#include "epoch.hh"
+
+namespace lwe {
+namespace mem {
+
+struct epoch::record {
+    epoch*              domain;
+    std::atomic<size_t> state; // (epoch << 1) | active
+    size_t              depth;
+    bool                orphan;
+    data::deque<item>   retired;
+};
+
+struct epoch::holder {
+    ~holder() noexcept {
+        for(record* r : list) {
+            // domain is destroyed: retired items are flushed by it
+            if(!r->domain) {
+                delete r;
+                continue;
+            }
+
+            // safe items go back while pools of this thread are alive
+            r->domain->advance();
+            flush(r, r->domain->current.load(std::memory_order_acquire));
+
+            std::lock_guard<std::mutex> guard(r->domain->lock);
+            r->state.store(0, std::memory_order_release);
+            r->orphan = true;
+        }
+    }
+
+    std::vector<record*> list;
+};
+
+epoch::epoch(size_t batch) noexcept: BATCH{ batch ? batch : 1 } {
+    current.store(0, std::memory_order_relaxed);
+}
+
+epoch::~epoch() noexcept {
+    std::lock_guard<std::mutex> guard(lock);
+    for(record* r : records) {
+        flush(r, SIZE_MAX);
+
+        // thread is alive: its holder deletes record
+        if(r->orphan) {
+            delete r;
+        } else r->domain = nullptr;
+    }
+}
+
+epoch& epoch::global() noexcept {
+    static epoch instance;
+    return instance;
+}
+
+void epoch::enter() noexcept {
+    record* self = local();
+    if(self->depth++ == 0) {
+        self->state.store((current.load(std::memory_order_relaxed) << 1) | 1, std::memory_order_seq_cst);
+    }
+}
+
+void epoch::leave() noexcept {
+    record* self = local();
+    if(--self->depth == 0) {
+        self->state.store(0, std::memory_order_release);
+    }
+}
+
+template<typename T> void epoch::retire(T* in) noexcept {
+    if(!in) return;
+
+    record* self = local();
+    item    out{ const_cast<void*>(static_cast<const void*>(in)), &destroy<T>, current.load(std::memory_order_seq_cst) };
+
+    // out of memory: collect makes room, else wait readers and return now
+    if(!self->retired.push(out)) {
+        collect();
+        if(!self->retired.push(out)) {
+            while(current.load(std::memory_order_acquire) < out.at + 2) {
+                if(!advance(self)) {
+                    std::this_thread::yield();
+                }
+            }
+            out.destroy(out.ptr);
+            pool::release(out.ptr);
+            return;
+        }
+    }
+
+    if(self->retired.size() % BATCH == 0) {
+        collect();
+    }
+}
+
+size_t epoch::collect() noexcept {
+    advance();
+
+    size_t now   = current.load(std::memory_order_acquire);
+    size_t count = flush(local(), now);
+
+    // ended threads
+    std::lock_guard<std::mutex> guard(lock);
+    for(auto i = records.begin(); i != records.end();) {
+        record* r = *i;
+        if(r->orphan) {
+            count += flush(r, now);
+            if(r->retired.size() == 0) {
+                delete r;
+                i = records.erase(i);
+                continue;
+            }
+        }
+        ++i;
+    }
+    return count;
+}
+
+auto epoch::local() noexcept -> record* {
+    static thread_local holder cache;
+    for(record* r : cache.list) {
+        if(r->domain == this) {
+            return r;
+        }
+    }
+
+    record* r = new record();
+    r->domain = this;
+    r->state.store(0, std::memory_order_relaxed);
+    r->depth  = 0;
+    r->orphan = false;
+
+    cache.list.push_back(r);
+
+    std::lock_guard<std::mutex> guard(lock);
+    records.push_back(r);
+    return r;
+}
+
+bool epoch::advance(const record* skip) noexcept {
+    size_t now = current.load(std::memory_order_seq_cst);
+
+    std::lock_guard<std::mutex> guard(lock);
+    for(record* r : records) {
+        if(r == skip) {
+            continue;
+        }
+        size_t state = r->state.load(std::memory_order_seq_cst);
+        if((state & 1) && (state >> 1) != now) {
+            return false; // reader in old epoch
+        }
+    }
+    return current.compare_exchange_strong(now, now + 1, std::memory_order_seq_cst);
+}
+
+size_t epoch::flush(record* in, size_t now) noexcept {
+    enum { E_BUFFER = 64 };
+
+    void*  buffer[E_BUFFER];
+    size_t size  = 0;
+    size_t count = 0;
+
+    // fifo: retired in order of epoch
+    while(item* front = in->retired.front()) {
+        if(now < 2 || front->at > now - 2) {
+            break;
+        }
+
+        item out;
+        in->retired.fifo(&out);
+        out.destroy(out.ptr);
+
+        buffer[size++] = out.ptr;
+        if(size == E_BUFFER) {
+            pool::release(buffer, size);
+            count += size;
+            size   = 0;
+        }
+    }
+
+    if(size) {
+        pool::release(buffer, size);
+        count += size;
+    }
+    return count;
+}
+
+template<typename T> void epoch::destroy(void* in) noexcept {
+    if constexpr(!std::is_pointer_v<T> && !std::is_void_v<T>) {
+        static_cast<T*>(in)->~T();
+    }
+}
+
+} // namespace mem
+} // namespace lwe
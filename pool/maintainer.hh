@@ -0,0 +1,85 @@
+#ifndef LWE_MAINTAINER_HEADER
+#define LWE_MAINTAINER_HEADER
+
+#include "pool.hh"
+#include "ticker.hh"
+
+#include <vector>
+
+namespace lwe {
+namespace mem {
+
+/*******************************************************************************
+ * background maintenance for attached pools
+ *
+ * tick() on each attached pool
+ *  1. try owner handshake: skip when owner is using it. (owner drains itself)
+ *  2. drain gc: remote free of sleeping owner.
+ *  3. trim idle blocks except 'keep'.
+ *  4. publish stats.
+ *
+ * how to use
+ *
+ * @code {.cpp}
+ *  maintainer::instance().start(std::chrono::milliseconds(100), 1);
+ *  pool::statics<sizeof(type)>().attach(); // on each owner thread
+ *  ...
+ *  for(auto& [p, s] : maintainer::instance().stats()) { ... }
+ * @endcode
+ *
+ * - tick() can be called without start(), eg. from a timer of user.
+ * - tick() is also called when quota::global() soft limit is crossed.
+ * - tick() inside tick() on same thread is skipped: eg. reclaim by allocation in drain.
+ * - pool guarded by calling thread is skipped: eg. reclaim by setup in construct.
+ ******************************************************************************/
+class maintainer {
+public:
+    maintainer(const maintainer&)            = delete;
+    maintainer& operator=(const maintainer&) = delete;
+    maintainer(maintainer&&)                 = delete;
+    maintainer& operator=(maintainer&&)      = delete;
+
+private:
+    /// @brief trims attached pools when quota::global() soft is crossed
+    maintainer();
+
+public:
+    /// @brief stop thread
+    ~maintainer() noexcept;
+
+public:
+    /// @brief process wide instance
+    static maintainer& instance() noexcept;
+
+public:
+    /// @brief start background thread, restart when running
+    /// @param [in] period - tick interval
+    /// @param [in] keep   - idle block count to keep per pool
+    void start(std::chrono::milliseconds period, size_t keep = 0);
+
+public:
+    /// @brief stop background thread and join
+    void stop() noexcept;
+
+public:
+    /// @brief one pass over attached pools
+    /// @return serviced pool count, 0 when nested on same thread
+    size_t tick(size_t keep = 0) noexcept;
+
+public:
+    /// @brief last published stats of attached pools
+    std::vector<std::pair<const pool*, pool::stats>> stats() const;
+
+private:
+    util::ticker loop;
+
+private:
+    /// @brief reclaim callback id of quota::global()
+    size_t reclaimer = 0;
+};
+
+} // namespace mem
+} // namespace lwe
+
+#include "maintainer.inl"
+#endif
@@ -0,0 +1,77 @@
+#include "maintainer.hh"
+
+namespace lwe {
+namespace mem {
+
+maintainer::maintainer() {
+    reclaimer = quota::global().attach([this] { tick(); });
+}
+
+maintainer::~maintainer() noexcept {
+    stop();
+    quota::global().detach(reclaimer);
+}
+
+maintainer& maintainer::instance() noexcept {
+    static maintainer instance;
+    return instance;
+}
+
+void maintainer::start(std::chrono::milliseconds period, size_t keep) {
+    loop.start(period, [this, keep] { tick(keep); });
+}
+
+void maintainer::stop() noexcept {
+    loop.stop();
+}
+
+size_t maintainer::tick(size_t keep) noexcept {
+    // drain and trim can allocate, over soft it calls reclaim and tick again
+    static thread_local bool ticking = false;
+    if(ticking) {
+        return 0; // nested: locker is held by this thread
+    }
+    ticking = true;
+
+    size_t count = 0;
+
+    // pool can not be destroyed while locked: detach waits
+    std::lock_guard<std::mutex> guard(pool::locker());
+    for(pool* target : pool::registry()) {
+        // this thread guards it: reclaim reached from charge in setup
+        if(pool::guard::held(target)) {
+            continue;
+        }
+
+        // owner is using: skip
+        uint8_t expect = pool::E_FREE;
+        if(!target->state.compare_exchange_strong(expect, pool::E_SERVICE, std::memory_order_acquire)) {
+            continue;
+        }
+
+        target->report.drained  = target->drain();
+        target->report.trimmed += target->trim(keep);
+        target->report.blocks   = target->all.size();
+        target->report.idle     = target->idle.size();
+
+        target->state.store(pool::E_FREE, std::memory_order_release);
+        ++count;
+    }
+
+    ticking = false;
+    return count;
+}
+
+std::vector<std::pair<const pool*, pool::stats>> maintainer::stats() const {
+    std::vector<std::pair<const pool*, pool::stats>> out;
+
+    std::lock_guard<std::mutex> guard(pool::locker());
+    out.reserve(pool::registry().size());
+    for(pool* target : pool::registry()) {
+        out.emplace_back(target, target->report);
+    }
+    return out;
+}
+
+} // namespace mem
+} // namespace lwe
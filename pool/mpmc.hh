@@ -0,0 +1,197 @@
+#ifndef LWE_MPMC_HEADER
+#define LWE_MPMC_HEADER
+
+#include "allocator.hh"
+
+namespace lwe {
+namespace data {
+
+/*******************************************************************************
+ * lock-free multi producer / multi consumer unbounded queue
+ *
+ * block: 'Size' - 1 slots and next pointer, slot has value and state bits.
+ *
+ *  head                         tail
+ *  ├─ index ─┐                  ├─ index ─┐
+ *  └─ block ─┼──> block ─> block ─> block ┘
+ *            └ offset = (index >> SHIFT) % Size
+ *
+ * - index is not reset on each block: grows forever, so CAS has no ABA.
+ * - offset 'Size - 1' is not a slot: block is being changed, wait.
+ * - producer: CAS tail index, write value, set WRITE bit.
+ * - consumer: CAS head index, wait WRITE bit, read value, set READ bit.
+ * - bulk: CAS once for run of slots in same block.
+ * - block is freed by last reader: all READ bits, no epoch or hazard pointer.
+ *   reader finds unread slot marks DESTROY, then that reader continues.
+ *
+ * NOTE: block is from mem::allocator, first block is created by first push.
+ * NOTE: wait for WRITE is spin: producer is preempted between CAS and write.
+ ******************************************************************************/
+template<typename T, size_t Size = config::DEF_CACHE> class mpmc_queue {
+    static_assert(Size >= 2, "need at least one slot in block");
+
+    struct slot;
+    struct block;
+
+public:
+    mpmc_queue();
+    ~mpmc_queue();
+
+public:
+    mpmc_queue(const mpmc_queue&)            = delete;
+    mpmc_queue(mpmc_queue&&)                 = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(mpmc_queue&&)      = delete;
+
+public:
+    /// @brief push back
+    /// @return false: failed to allocate
+    template<typename Arg> bool push(Arg&&) noexcept;
+
+public:
+    /// @brief push back by copy, CAS once per block
+    /// @return pushed count, less than input when failed to allocate
+    size_t push(const T*, size_t) noexcept;
+
+public:
+    /// @brief pop front, moved to out then destructor
+    /// @return false: at empty
+    bool pop(T*) noexcept;
+
+public:
+    /// @brief pop front up to count, CAS once per block
+    /// @return popped count, 0 is empty
+    size_t pop(T*, size_t) noexcept;
+
+public:
+    /// @brief nothing to pop, at the time of call
+    bool empty() const noexcept;
+
+private:
+    /// @brief producer: reserve slots in tail block
+    /// @return reserved count, 0 is failed to allocate
+    size_t reserve(size_t, block**, size_t*) noexcept;
+
+private:
+    /// @brief consumer: acquire slots in head block
+    /// @return acquired count, 0 is empty
+    size_t acquire(size_t, block**, size_t*) noexcept;
+
+private:
+    /// @brief consumer: slot is read, free block when last
+    static void settle(block*, size_t) noexcept;
+
+private:
+    /// @brief free block when all slots from start are read, else hand off
+    static void destroy(block*, size_t) noexcept;
+
+private:
+    /// @brief block allocate and deallocate, not counted to account tag
+    static block* create() noexcept;
+    static void   remove(block*) noexcept;
+
+private:
+    enum : size_t {
+        SHIFT    = 1,
+        HAS_NEXT = 1,        // head only: tail is in other block
+        LAP      = Size,     // index per block
+        CAP      = Size - 1, // slot per block
+    };
+
+    enum : uint8_t {
+        E_WRITE   = 1,
+        E_READ    = 2,
+        E_DESTROY = 4,
+    };
+
+private:
+    struct position {
+        std::atomic<size_t> index;
+        std::atomic<block*> ptr;
+    };
+    alignas(64) position head;
+    alignas(64) position tail;
+};
+
+/*******************************************************************************
+ * lock-free multi producer / multi consumer bounded queue
+ *
+ * ring of cells, cell has value and sequence.
+ *
+ *  head            tail
+ *  ├─ index ──┐    ├─ index ──┐
+ *  └─ cell: [ seq | value ] ... [ seq | value ] ─┐  index & mask is cell
+ *      ↑                                         │
+ *      └─────────────────────────────────────────┘
+ *
+ * - producer: cell seq == index: CAS tail, write value, seq = index + 1.
+ * - consumer: cell seq == index + 1: CAS head, read value, seq = index + capacity.
+ * - seq behind index: full (producer) or empty (consumer), returns at once.
+ * - bulk: leading run of ready cells is claimed by one CAS, stops at full or empty.
+ *
+ * for when push can be refused: thread_pool inject, back pressure.
+ * remote free of pool can not be refused: mpmc_queue.
+ *
+ * NOTE: cells are from mem::allocator when created, capacity is power of 2.
+ ******************************************************************************/
+template<typename T> class mpmc_ring {
+    struct cell;
+
+public:
+    /// @param [in] capacity - cell count, adjusted to the power of 2 (min: pointer size)
+    explicit mpmc_ring(size_t capacity = config::DEF_CACHE);
+    ~mpmc_ring();
+
+public:
+    mpmc_ring(const mpmc_ring&)            = delete;
+    mpmc_ring(mpmc_ring&&)                 = delete;
+    mpmc_ring& operator=(const mpmc_ring&) = delete;
+    mpmc_ring& operator=(mpmc_ring&&)      = delete;
+
+public:
+    /// @brief push back
+    /// @return false: full, or failed to allocate cells when created
+    template<typename Arg> bool push(Arg&&) noexcept;
+
+public:
+    /// @brief push back by copy, CAS once per run
+    /// @return pushed count, less than input when full
+    size_t push(const T*, size_t) noexcept;
+
+public:
+    /// @brief pop front, moved to out then destructor, nullptr: discard
+    /// @return false: at empty
+    bool pop(T*) noexcept;
+
+public:
+    /// @brief pop front up to count, CAS once per run, nullptr: discard
+    /// @return popped count, 0 is empty
+    size_t pop(T*, size_t) noexcept;
+
+public:
+    /// @brief nothing to pop, at the time of call
+    bool empty() const noexcept;
+
+public:
+    /// @brief cell count, 0 when failed to allocate
+    size_t capacity() const noexcept;
+
+private:
+    /// @brief move position over ready cells: sequence is index + ready
+    /// @return claimed count from 'at', 0 is full or empty
+    size_t claim(std::atomic<size_t>& position, size_t count, size_t ready, size_t* at) noexcept;
+
+private:
+    cell*  cells = nullptr;
+    size_t mask  = 0;
+
+private:
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+};
+
+} // namespace data
+} // namespace lwe
+
+#include "mpmc.inl"
+#endif
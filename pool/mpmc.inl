@@ -0,0 +1,471 @@
+#include "mpmc.hh"
+
+namespace lwe {
+namespace data {
+
+template<typename T, size_t Size> struct mpmc_queue<T, Size>::slot {
+    /// @brief union for ignore calls to constructor and destructor
+    union {
+        T       value;
+        uint8_t serialized[sizeof(T)];
+    };
+
+    std::atomic<uint8_t> state;
+};
+
+template<typename T, size_t Size> struct mpmc_queue<T, Size>::block {
+    std::atomic<block*> next;
+    slot                slots[CAP];
+};
+
+template<typename T, size_t Size> mpmc_queue<T, Size>::mpmc_queue() {
+    // first block is created by first push
+    head.index.store(0, std::memory_order_relaxed);
+    head.ptr.store(nullptr, std::memory_order_relaxed);
+    tail.index.store(0, std::memory_order_relaxed);
+    tail.ptr.store(nullptr, std::memory_order_relaxed);
+}
+
+template<typename T, size_t Size> mpmc_queue<T, Size>::~mpmc_queue() {
+    size_t from = head.index.load(std::memory_order_relaxed) >> SHIFT;
+    size_t to   = tail.index.load(std::memory_order_relaxed) >> SHIFT;
+    block* curr = head.ptr.load(std::memory_order_relaxed);
+
+    for(; from != to; ++from) {
+        size_t offset = from % LAP;
+        if(offset < CAP) {
+            curr->slots[offset].value.~T();
+        } else {
+            block* next = curr->next.load(std::memory_order_relaxed);
+            remove(curr);
+            curr = next;
+        }
+    }
+
+    if(curr) {
+        remove(curr);
+    }
+}
+
+template<typename T, size_t Size> template<typename Arg> bool mpmc_queue<T, Size>::push(Arg&& in) noexcept {
+    block* curr;
+    size_t offset;
+    if(!reserve(1, &curr, &offset)) {
+        return false;
+    }
+
+    slot& dest = curr->slots[offset];
+    new(&dest.value) T(std::forward<Arg>(in));
+    dest.state.fetch_or(E_WRITE, std::memory_order_release);
+    return true;
+}
+
+template<typename T, size_t Size> size_t mpmc_queue<T, Size>::push(const T* in, size_t count) noexcept {
+    size_t done = 0;
+    while(done < count) {
+        block* curr;
+        size_t offset;
+        size_t got = reserve(count - done, &curr, &offset);
+        if(!got) {
+            break;
+        }
+
+        for(size_t i = 0; i < got; ++i) {
+            slot& dest = curr->slots[offset + i];
+            new(&dest.value) T(in[done + i]);
+            dest.state.fetch_or(E_WRITE, std::memory_order_release);
+        }
+        done += got;
+    }
+    return done;
+}
+
+template<typename T, size_t Size> bool mpmc_queue<T, Size>::pop(T* out) noexcept {
+    return pop(out, 1) != 0;
+}
+
+template<typename T, size_t Size> size_t mpmc_queue<T, Size>::pop(T* out, size_t count) noexcept {
+    size_t done = 0;
+    while(done < count) {
+        block* curr;
+        size_t offset;
+        size_t got = acquire(count - done, &curr, &offset);
+        if(!got) {
+            break;
+        }
+
+        for(size_t i = 0; i < got; ++i) {
+            slot& from = curr->slots[offset + i];
+            while(!(from.state.load(std::memory_order_acquire) & E_WRITE)) {
+                std::this_thread::yield();
+            }
+            if(out) {
+                out[done + i] = std::move(from.value);
+            }
+            from.value.~T();
+            settle(curr, offset + i); // can be freed after last
+        }
+        done += got;
+    }
+    return done;
+}
+
+template<typename T, size_t Size> bool mpmc_queue<T, Size>::empty() const noexcept {
+    size_t from = head.index.load(std::memory_order_seq_cst);
+    size_t to   = tail.index.load(std::memory_order_seq_cst);
+    return (from >> SHIFT) == (to >> SHIFT);
+}
+
+template<typename T, size_t Size>
+size_t mpmc_queue<T, Size>::reserve(size_t count, block** out, size_t* at) noexcept {
+    block* next = nullptr;
+
+    size_t index = tail.index.load(std::memory_order_acquire);
+    while(true) {
+        block* curr   = tail.ptr.load(std::memory_order_acquire);
+        size_t offset = (index >> SHIFT) % LAP;
+
+        // other thread is installing next block
+        if(offset == CAP) {
+            std::this_thread::yield();
+            index = tail.index.load(std::memory_order_acquire);
+            continue;
+        }
+
+        // first push
+        if(!curr) {
+            block* first = create();
+            if(!first) {
+                return 0;
+            }
+            block* expect = nullptr;
+            if(tail.ptr.compare_exchange_strong(expect, first, std::memory_order_release)) {
+                head.ptr.store(first, std::memory_order_release);
+            } else remove(first);
+            index = tail.index.load(std::memory_order_acquire);
+            continue;
+        }
+
+        // fills block: prepare next, or leave last slot to other
+        size_t got = count < CAP - offset ? count : CAP - offset;
+        if(offset + got == CAP && !next) {
+            next = create();
+            if(!next) {
+                if(--got == 0) {
+                    return 0;
+                }
+            }
+        }
+
+        size_t after = index + (got << SHIFT);
+        if(tail.index.compare_exchange_weak(index, after, std::memory_order_seq_cst, std::memory_order_acquire)) {
+            if(offset + got == CAP) {
+                tail.ptr.store(next, std::memory_order_release);
+                tail.index.store(after + (1 << SHIFT), std::memory_order_release);
+                curr->next.store(next, std::memory_order_release);
+                next = nullptr;
+            }
+
+            if(next) {
+                remove(next);
+            }
+            *out = curr;
+            *at  = offset;
+            return got;
+        }
+    }
+}
+
+template<typename T, size_t Size>
+size_t mpmc_queue<T, Size>::acquire(size_t count, block** out, size_t* at) noexcept {
+    size_t index = head.index.load(std::memory_order_acquire);
+    while(true) {
+        block* curr   = head.ptr.load(std::memory_order_acquire);
+        size_t offset = (index >> SHIFT) % LAP;
+
+        // other thread is moving to next block
+        if(offset == CAP) {
+            std::this_thread::yield();
+            index = head.index.load(std::memory_order_acquire);
+            continue;
+        }
+
+        size_t got  = count < CAP - offset ? count : CAP - offset;
+        size_t flag = 0;
+
+        // tail was in same block: check count
+        if(!(index & HAS_NEXT)) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            size_t last = tail.index.load(std::memory_order_relaxed) >> SHIFT;
+            size_t from = index >> SHIFT;
+            if(from == last) {
+                return 0;
+            }
+
+            if(from / LAP != last / LAP) {
+                flag = HAS_NEXT;
+            } else if(last - from < got) {
+                got = last - from;
+            }
+        }
+
+        // first block is not published yet
+        if(!curr) {
+            std::this_thread::yield();
+            index = head.index.load(std::memory_order_acquire);
+            continue;
+        }
+
+        size_t after = (index + (got << SHIFT)) | flag;
+        if(head.index.compare_exchange_weak(index, after, std::memory_order_seq_cst, std::memory_order_acquire)) {
+            if(offset + got == CAP) {
+                block* next = curr->next.load(std::memory_order_acquire);
+                while(!next) {
+                    std::this_thread::yield();
+                    next = curr->next.load(std::memory_order_acquire);
+                }
+
+                size_t index = (after & ~size_t(HAS_NEXT)) + (1 << SHIFT);
+                if(next->next.load(std::memory_order_relaxed)) {
+                    index |= HAS_NEXT;
+                }
+                head.ptr.store(next, std::memory_order_release);
+                head.index.store(index, std::memory_order_release);
+            }
+
+            *out = curr;
+            *at  = offset;
+            return got;
+        }
+    }
+}
+
+template<typename T, size_t Size> void mpmc_queue<T, Size>::settle(block* in, size_t offset) noexcept {
+    // last slot: begin to free
+    if(offset + 1 == CAP) {
+        destroy(in, 0);
+    }
+
+    // other reader was waiting this: continue to free
+    else if(in->slots[offset].state.fetch_or(E_READ, std::memory_order_acq_rel) & E_DESTROY) {
+        destroy(in, offset + 1);
+    }
+}
+
+template<typename T, size_t Size> void mpmc_queue<T, Size>::destroy(block* in, size_t from) noexcept {
+    // last slot is not checked: its reader has begun
+    for(size_t i = from; i < CAP - 1; ++i) {
+        std::atomic<uint8_t>& state = in->slots[i].state;
+        if(!(state.load(std::memory_order_acquire) & E_READ) &&
+           !(state.fetch_or(E_DESTROY, std::memory_order_acq_rel) & E_READ)) {
+            return; // that reader will continue
+        }
+    }
+    remove(in);
+}
+
+template<typename T, size_t Size> auto mpmc_queue<T, Size>::create() noexcept -> block* {
+    mem::account::scope internal(mem::account::NONE);
+
+    block* ptr = static_cast<block*>(mem::allocator::malloc(sizeof(block), alignof(block)));
+    if(!ptr) {
+        return nullptr;
+    }
+
+    new(&ptr->next) std::atomic<block*>(nullptr);
+    for(size_t i = 0; i < CAP; ++i) {
+        new(&ptr->slots[i].state) std::atomic<uint8_t>(0);
+    }
+    return ptr;
+}
+
+template<typename T, size_t Size> void mpmc_queue<T, Size>::remove(block* in) noexcept {
+    mem::account::scope internal(mem::account::NONE);
+    mem::allocator::free(in);
+}
+
+template<typename T> struct mpmc_ring<T>::cell {
+    std::atomic<size_t> sequence;
+
+    /// @brief union for ignore calls to constructor and destructor
+    union {
+        T       value;
+        uint8_t serialized[sizeof(T)];
+    };
+};
+
+template<typename T> mpmc_ring<T>::mpmc_ring(size_t capacity) {
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+
+    mem::account::scope internal(mem::account::NONE);
+
+    size_t count = util::aligner::boundary(capacity);
+    cells        = static_cast<cell*>(mem::allocator::malloc(sizeof(cell) * count, alignof(cell)));
+    if(!cells) {
+        return;
+    }
+
+    mask = count - 1;
+    for(size_t i = 0; i < count; ++i) {
+        new(&cells[i].sequence) std::atomic<size_t>(i);
+    }
+}
+
+template<typename T> mpmc_ring<T>::~mpmc_ring() {
+    if(!cells) {
+        return;
+    }
+
+    size_t from = head.load(std::memory_order_relaxed);
+    size_t to   = tail.load(std::memory_order_relaxed);
+    for(; from != to; ++from) {
+        cells[from & mask].value.~T();
+    }
+
+    mem::account::scope internal(mem::account::NONE);
+    mem::allocator::free(cells);
+}
+
+template<typename T> template<typename Arg> bool mpmc_ring<T>::push(Arg&& in) noexcept {
+    if(!cells) {
+        return false;
+    }
+
+    size_t index = tail.load(std::memory_order_relaxed);
+    cell*  dest;
+    while(true) {
+        dest         = &cells[index & mask];
+        size_t state = dest->sequence.load(std::memory_order_acquire);
+        int64_t diff = int64_t(state - index);
+
+        // free cell: claim
+        if(diff == 0) {
+            if(tail.compare_exchange_weak(index, index + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        // not read in previous lap
+        else if(diff < 0) {
+            return false;
+        }
+
+        // claimed by other producer
+        else index = tail.load(std::memory_order_relaxed);
+    }
+
+    new(&dest->value) T(std::forward<Arg>(in));
+    dest->sequence.store(index + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T> size_t mpmc_ring<T>::push(const T* in, size_t count) noexcept {
+    size_t index;
+    size_t got = claim(tail, count, 0, &index);
+    for(size_t i = 0; i < got; ++i) {
+        cell* dest = &cells[(index + i) & mask];
+        new(&dest->value) T(in[i]);
+        dest->sequence.store(index + i + 1, std::memory_order_release);
+    }
+    return got;
+}
+
+template<typename T> bool mpmc_ring<T>::pop(T* out) noexcept {
+    if(!cells) {
+        return false;
+    }
+
+    size_t index = head.load(std::memory_order_relaxed);
+    cell*  from;
+    while(true) {
+        from         = &cells[index & mask];
+        size_t state = from->sequence.load(std::memory_order_acquire);
+        int64_t diff = int64_t(state - (index + 1));
+
+        // written cell: claim
+        if(diff == 0) {
+            if(head.compare_exchange_weak(index, index + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        // not written yet
+        else if(diff < 0) {
+            return false;
+        }
+
+        // claimed by other consumer
+        else index = head.load(std::memory_order_relaxed);
+    }
+
+    if(out) {
+        *out = std::move(from->value);
+    }
+    from->value.~T();
+    from->sequence.store(index + mask + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T> size_t mpmc_ring<T>::pop(T* out, size_t count) noexcept {
+    size_t index;
+    size_t got = claim(head, count, 1, &index);
+    for(size_t i = 0; i < got; ++i) {
+        cell* from = &cells[(index + i) & mask];
+        if(out) {
+            out[i] = std::move(from->value);
+        }
+        from->value.~T();
+        from->sequence.store(index + i + mask + 1, std::memory_order_release);
+    }
+    return got;
+}
+
+template<typename T>
+size_t mpmc_ring<T>::claim(std::atomic<size_t>& position, size_t count, size_t ready, size_t* at) noexcept {
+    if(!cells || count == 0) {
+        return 0;
+    }
+
+    size_t index = position.load(std::memory_order_relaxed);
+    while(true) {
+        // leading run of ready cells, up to count and capacity
+        size_t run = 0;
+        size_t max = count < mask + 1 ? count : mask + 1;
+        while(run < max) {
+            size_t state = cells[(index + run) & mask].sequence.load(std::memory_order_acquire);
+            if(state != index + run + ready) {
+                break;
+            }
+            ++run;
+        }
+
+        if(run) {
+            // cells of run can be changed only by who moves position over them
+            if(position.compare_exchange_weak(index, index + run, std::memory_order_relaxed)) {
+                *at = index;
+                return run;
+            }
+            continue;
+        }
+
+        // first cell is behind: full or empty
+        size_t  state = cells[index & mask].sequence.load(std::memory_order_acquire);
+        int64_t diff  = int64_t(state - (index + ready));
+        if(diff < 0) {
+            return 0;
+        }
+        index = position.load(std::memory_order_relaxed);
+    }
+}
+
+template<typename T> bool mpmc_ring<T>::empty() const noexcept {
+    return head.load(std::memory_order_acquire) >= tail.load(std::memory_order_acquire);
+}
+
+template<typename T> size_t mpmc_ring<T>::capacity() const noexcept {
+    return cells ? mask + 1 : 0;
+}
+
+} // namespace data
+} // namespace lwe
@@ -0,0 +1,90 @@
+#ifndef LWE_PARALLEL_HEADER
+#define LWE_PARALLEL_HEADER
+
+#include "deque.hh"
+#include "thread_pool.hh"
+
+namespace lwe {
+namespace data {
+
+/*******************************************************************************
+ * parallel algorithms over deque, node granularity
+ *
+ * ┌──────┬──────┬──────┬──────┬──────┬──────┐
+ * │ node │ node │ node │ node │ node │ node │ << contiguous arrays
+ * └──────┴──────┼──────┴──────┼──────┴──────┘
+ *   batch 0     │ batch 1     │ batch 2        << claimed by atomic index
+ *
+ * - batch is a range of nodes: its arrays are found by node map of deque, O(1).
+ * - caller runs batches too, helpers are submitted to thread pool.
+ * - caller waits for batches, not for helpers:
+ *   late helper finds nothing and returns, so it is safe from worker thread.
+ * - reduce: batch results are combined in node order.
+ *
+ * how to use
+ *
+ * @code {.cpp}
+ *  parallel_for_each(values, [](double& v) { v *= 2; });
+ *  double total = parallel_transform_reduce(
+ *      values, 0.0, [](const double& v) { return v * v; }, std::plus<>());
+ * @endcode
+ *
+ * - without thread pool argument, process wide default pool is used.
+ *
+ * NOTE: deque must not be changed while running.
+ * NOTE: fn must not throw, combine must be associative.
+ ******************************************************************************/
+class parallel {
+public:
+    parallel() = delete;
+
+public:
+    /// @brief process wide pool, hardware concurrency
+    static exec::thread_pool& shared();
+
+public:
+    /// @brief run fn(index) for [0, count) on caller and helpers, return when all done
+    template<typename F> static void run(exec::thread_pool&, size_t count, F&& fn);
+
+public:
+    /// @brief node count of deque elements
+    template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline>
+    static size_t nodes(const deque<T, Size, Align, Cache, Inline>&);
+
+public:
+    /// @brief element range of batch: multiple of node size, [from, to)
+    template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline>
+    static std::pair<size_t, size_t> range(const deque<T, Size, Align, Cache, Inline>&, size_t index, size_t count);
+
+public:
+    /// @brief batch count for segment count
+    static size_t batches(exec::thread_pool&, size_t segments);
+
+private:
+    /// @brief shared state of one run, freed by last one
+    struct job;
+
+private:
+    /// @brief claim and run batches
+    static void work(job*);
+};
+
+/// @brief fn(T&) for each element, by node on thread pool
+template<typename D, typename F> void parallel_for_each(exec::thread_pool&, D&, F&&);
+
+/// @brief fn(T&) for each element, on parallel::shared()
+template<typename D, typename F> void parallel_for_each(D&, F&&);
+
+/// @brief combine(init, map(T)...), by node on thread pool
+template<typename D, typename R, typename M, typename C>
+R parallel_transform_reduce(exec::thread_pool&, const D&, R init, M&& map, C&& combine);
+
+/// @brief combine(init, map(T)...), on parallel::shared()
+template<typename D, typename R, typename M, typename C>
+R parallel_transform_reduce(const D&, R init, M&& map, C&& combine);
+
+} // namespace data
+} // namespace lwe
+
+#include "parallel.inl"
+#endif
@@ -0,0 +1,164 @@
+#include "parallel.hh"
+
+namespace lwe {
+namespace data {
+
+struct parallel::job {
+    std::atomic<size_t> next;
+    std::atomic<size_t> done;
+    std::atomic<size_t> refs;
+    size_t              total;
+
+    /// @brief type erased fn of caller stack
+    void (*call)(void*, size_t);
+    void* context;
+
+    std::mutex              lock;
+    std::condition_variable signal;
+};
+
+exec::thread_pool& parallel::shared() {
+    static exec::thread_pool instance;
+    return instance;
+}
+
+template<typename F> void parallel::run(exec::thread_pool& pool, size_t count, F&& fn) {
+    if(count == 0) {
+        return;
+    }
+
+    // nothing to share
+    if(count == 1 || pool.size() < 2) {
+        for(size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    void* ptr  = mem::allocator::malloc(sizeof(job), alignof(job));
+    job*  self = ptr ? new(ptr) job() : nullptr;
+    if(!self) {
+        for(size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    size_t helpers = pool.size() - 1 < count - 1 ? pool.size() - 1 : count - 1;
+    self->next.store(0, std::memory_order_relaxed);
+    self->done.store(0, std::memory_order_relaxed);
+    self->refs.store(helpers + 2, std::memory_order_relaxed); // helpers, caller work and wait
+    self->total   = count;
+    self->context = const_cast<void*>(static_cast<const void*>(&fn));
+    self->call    = [](void* context, size_t index) { (*static_cast<std::remove_reference_t<F>*>(context))(index); };
+
+    for(size_t i = 0; i < helpers; ++i) {
+        if(!pool.submit([self] { work(self); })) {
+            self->refs.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    // caller is a helper too: done without pool when all workers are busy
+    work(self);
+
+    {
+        std::unique_lock<std::mutex> guard(self->lock);
+        self->signal.wait(guard, [self] { return self->done.load(std::memory_order_acquire) == self->total; });
+    }
+
+    if(self->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        self->~job();
+        mem::allocator::free(self);
+    }
+}
+
+void parallel::work(job* self) {
+    size_t count = 0;
+    size_t index;
+    while((index = self->next.fetch_add(1, std::memory_order_relaxed)) < self->total) {
+        self->call(self->context, index);
+        ++count;
+    }
+
+    // last batch: wake caller, lock for not missing signal
+    if(count && self->done.fetch_add(count, std::memory_order_acq_rel) + count == self->total) {
+        { std::lock_guard<std::mutex> guard(self->lock); }
+        self->signal.notify_all();
+    }
+
+    if(self->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        self->~job();
+        mem::allocator::free(self);
+    }
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline>
+size_t parallel::nodes(const deque<T, Size, Align, Cache, Inline>& in) {
+    return (in.size() + Size - 1) / Size;
+}
+
+template<typename T, size_t Size, size_t Align, size_t Cache, bool Inline>
+std::pair<size_t, size_t> parallel::range(const deque<T, Size, Align, Cache, Inline>& in, size_t index, size_t count) {
+    size_t total = nodes(in);
+    size_t from  = total * index / count * Size;
+    size_t to    = total * (index + 1) / count * Size;
+    return { from, to < in.size() ? to : in.size() };
+}
+
+size_t parallel::batches(exec::thread_pool& pool, size_t segments) {
+    // some more than workers: balance uneven fn cost
+    size_t out = pool.size() << 2;
+    return out < segments ? out : segments;
+}
+
+template<typename D, typename F> void parallel_for_each(exec::thread_pool& pool, D& in, F&& fn) {
+    size_t count = parallel::batches(pool, parallel::nodes(in));
+
+    parallel::run(pool, count, [&](size_t index) {
+        auto [from, to] = parallel::range(in, index, count);
+        in.segments(from, to, [&fn](auto* ptr, size_t n) {
+            for(size_t i = 0; i < n; ++i) {
+                fn(ptr[i]);
+            }
+        });
+    });
+}
+
+template<typename D, typename F> void parallel_for_each(D& in, F&& fn) {
+    parallel_for_each(parallel::shared(), in, std::forward<F>(fn));
+}
+
+template<typename D, typename R, typename M, typename C>
+R parallel_transform_reduce(exec::thread_pool& pool, const D& in, R init, M&& map, C&& combine) {
+    size_t count = parallel::batches(pool, parallel::nodes(in));
+
+    // batch is not empty: first mapped element is start
+    std::vector<R> results(count, init);
+    parallel::run(pool, count, [&](size_t index) {
+        auto [from, to] = parallel::range(in, index, count);
+
+        R&   out   = results[index];
+        bool first = true;
+        in.segments(from, to, [&](auto* ptr, size_t n) {
+            for(size_t i = 0; i < n; ++i) {
+                if(first) {
+                    out   = map(ptr[i]);
+                    first = false;
+                } else out = combine(std::move(out), map(ptr[i]));
+            }
+        });
+    });
+
+    for(size_t i = 0; i < count; ++i) {
+        init = combine(std::move(init), std::move(results[i]));
+    }
+    return init;
+}
+
+template<typename D, typename R, typename M, typename C>
+R parallel_transform_reduce(const D& in, R init, M&& map, C&& combine) {
+    return parallel_transform_reduce(parallel::shared(), in, std::move(init), std::forward<M>(map), std::forward<C>(combine));
+}
+
+} // namespace data
+} // namespace lwe
@@ -0,0 +1,143 @@
+#ifndef LWE_PERCPU_HEADER
+#define LWE_PERCPU_HEADER
+
+#include "allocator.hh"
+
+#include <mutex>
+#include <thread>
+
+#if defined(__linux__)
+#    include <sched.h>
+#    if __has_include(<sys/rseq.h>)
+#        include <sys/rseq.h>
+#        define LWE_RSEQ 1
+#    endif
+#endif
+
+#ifndef LWE_RSEQ
+#    define LWE_RSEQ 0
+#endif
+
+namespace lwe {
+namespace mem {
+
+/*******************************************************************************
+ * NOTE: SHARED BY ALL THREADS, CACHE IS PER CPU
+ *******************************************************************************
+ * structure
+ *
+ * ┌──────────────────────────────────────┐
+ * │ slot[cpu 0] │ slot[cpu 1] │ ...      │ << cache line aligned, DEPTH chunks
+ * └──────┬──────┴──────┬──────┴──────────┘
+ *        └─ refill / flush (half of DEPTH) ─┐
+ *                                           v
+ * ┌──────────────────────────────────────────┐
+ * │ central free list (mutex) │ blocks       │ << shared, COUNT chunks per block
+ * └──────────────────────────────────────────┘
+ *
+ * - block: COUNT chunks and pointer to next generated block, no allocation to track.
+ *
+ * - cpu id is read from rseq area (linux, glibc 2.35+) when it is registered.
+ * - fallback: sched_getcpu(), else thread id hash.
+ * - NOTE: this is a try-lock design, not a rseq critical section.
+ *   cpu id only picks a slot, the slot is guarded by atomic_flag, nothing is restarted.
+ *   if thread is preempted or migrated in section, other thread does not wait,
+ *   it goes to central free list directly.
+ * - cache memory is bound by cpu count, not thread count.
+ *
+ * how to use
+ *
+ * @code {.cpp}
+ *  type* ptr = percpu::statics<sizeof(type)>().construct<type>(...); // any thread
+ *  percpu::statics<sizeof(type)>().destruct<type>(ptr);              // any thread
+ * @endcode
+ *
+ * NOTE: chunk has no meta, so destruct to same instance.
+ ******************************************************************************/
+class percpu {
+public:
+    percpu(const percpu&)            = delete;
+    percpu& operator=(const percpu&) = delete;
+    percpu(percpu&&)                 = delete;
+    percpu& operator=(percpu&&)      = delete;
+
+private:
+    /// @brief per cpu cache
+    struct slot;
+
+public:
+    /**
+     * @brief process wide static instance
+     * @note  different template parameter result in different types
+     */
+    template<size_t Size, size_t Align = config::DEF_ALIGN, size_t Count = config::DEF_CACHE> static percpu& statics();
+
+public:
+    /**
+     * @brief construct a new percpu object
+     *
+     * @param [in] chunk - chunk size, it is padded to the pointer size.
+     * @param [in] align - chunk align, it is adjusted to the power of 2.
+     * @param [in] count - chunk count in shared block, at least 1.
+     * @param [in] depth - cached chunk count per cpu.
+     */
+    percpu(size_t chunk,
+           size_t align = config::DEF_ALIGN,
+           size_t count = config::DEF_CACHE,
+           size_t depth = config::DEF_CACHE) noexcept;
+
+public:
+    /// @brief destroy all blocks
+    ~percpu() noexcept;
+
+public:
+    /// @brief get memory from current cpu cache, refill from central when empty.
+    template<typename T = void, typename... Args> T* construct(Args&&...) noexcept;
+
+public:
+    /// @brief return memory to current cpu cache, flush to central when full.
+    template<typename T = void> void destruct(T*) noexcept;
+
+public:
+    /// @brief current cpu index
+    static size_t cpu() noexcept;
+
+private:
+    /// @brief central: get chunk, allocate block when empty
+    void* pull() noexcept;
+
+private:
+    /// @brief central: return chunk
+    void push(void*) noexcept;
+
+private:
+    /// @brief central: allocate block, call when locked
+    bool setup() noexcept;
+
+private:
+    const size_t ALIGN;
+    const size_t CHUNK;
+    const size_t COUNT;
+    const size_t TOTAL;
+    const size_t DEPTH;
+    const size_t SLOTS;
+
+private:
+    /// @brief per cpu cache array
+    slot* slots = nullptr;
+
+private:
+    /// @brief central free list
+    void*      central = nullptr;
+    std::mutex lock;
+
+private:
+    /// @brief generated blocks, linked by pointer after last chunk
+    uint8_t* blocks = nullptr;
+};
+
+} // namespace mem
+} // namespace lwe
+
+#include "percpu.inl"
+#endif
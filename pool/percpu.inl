@@ -0,0 +1,188 @@
+#include "percpu.hh"
+
+namespace lwe {
+namespace mem {
+
+struct alignas(64) percpu::slot {
+    std::atomic_flag busy = ATOMIC_FLAG_INIT;
+    size_t           count;
+    void**           cache;
+};
+
+template<size_t Size, size_t Align, size_t Count> percpu& percpu::statics() {
+    static percpu instance(Size, Align, Count);
+    return instance;
+}
+
+// clang-format off
+percpu::percpu(size_t chunk, size_t align, size_t count, size_t depth) noexcept :
+    ALIGN{ util::aligner::boundary(align) },
+    CHUNK{ util::aligner::padding(chunk < sizeof(void*) ? sizeof(void*) : chunk, ALIGN) },
+    COUNT{ util::aligner::padding(count ? count : 1, config::DEF_CACHE) },
+    TOTAL{ CHUNK * COUNT + sizeof(void*) },
+    DEPTH{ depth < 2 ? 2 : depth },
+    SLOTS{ std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1 }
+{
+    account::scope internal(account::NONE);
+
+    slots = static_cast<slot*>(allocator::malloc(sizeof(slot) * SLOTS, alignof(slot)));
+    if(!slots) {
+        return;
+    }
+    for(size_t i = 0; i < SLOTS; ++i) {
+        new(slots + i) slot();
+        slots[i].count = 0;
+        slots[i].cache = static_cast<void**>(allocator::malloc(sizeof(void*) * DEPTH));
+    }
+}
+// clang-format on
+
+percpu::~percpu() noexcept {
+    if(slots) {
+        for(size_t i = 0; i < SLOTS; ++i) {
+            allocator::free(slots[i].cache);
+        }
+        allocator::free(slots);
+    }
+    while(blocks) {
+        uint8_t* next = *reinterpret_cast<uint8_t**>(blocks + CHUNK * COUNT);
+        allocator::free(blocks);
+        blocks = next;
+    }
+}
+
+size_t percpu::cpu() noexcept {
+#if LWE_RSEQ
+    // registered by libc: size covers cpu_id, cpu_id is not negative (uninitialized / failed)
+    if(__rseq_size >= offsetof(struct rseq, cpu_id) + sizeof(uint32_t)) {
+        auto area = reinterpret_cast<const volatile struct rseq*>(
+            static_cast<const char*>(__builtin_thread_pointer()) + __rseq_offset);
+        int32_t id = static_cast<int32_t>(area->cpu_id);
+        if(id >= 0) {
+            return static_cast<size_t>(id);
+        }
+    }
+#endif
+#if defined(__linux__)
+    int id = ::sched_getcpu();
+    if(id >= 0) {
+        return static_cast<size_t>(id);
+    }
+#endif
+    return std::hash<std::thread::id>{}(std::this_thread::get_id());
+}
+
+template<typename T, typename... Args> inline T* percpu::construct(Args&&... args) noexcept {
+    void* ptr = nullptr;
+
+    if(slots) {
+        slot& self = slots[cpu() % SLOTS];
+
+        // contended: other thread is in section on same cpu, go to central
+        if(!self.busy.test_and_set(std::memory_order_acquire)) {
+            // refill half
+            if(self.count == 0 && self.cache) {
+                std::lock_guard<std::mutex> guard(lock);
+                for(size_t i = 0, loop = DEPTH >> 1; i < loop; ++i) {
+                    if(!central && !setup()) {
+                        break;
+                    }
+                    self.cache[self.count++] = central;
+                    central                  = *reinterpret_cast<void**>(central);
+                }
+            }
+            if(self.count) {
+                ptr = self.cache[--self.count];
+            }
+            self.busy.clear(std::memory_order_release);
+        }
+    }
+
+    if(!ptr) {
+        ptr = pull();
+    }
+
+    // EXCEPTION
+    if(!ptr) {
+        return nullptr;
+    }
+
+    T* ret = reinterpret_cast<T*>(ptr);
+    if constexpr(!std::is_pointer_v<T> && !std::is_same_v<T, void>) {
+        new(ret) T({ std::forward<Args>(args)... }); // new
+    }
+    return ret;
+}
+
+template<typename T> void percpu::destruct(T* in) noexcept {
+    if(!in) return;
+
+    // delete
+    if constexpr(!std::is_pointer_v<T> && !std::is_void_v<T>) {
+        in->~T();
+    }
+
+    if(slots) {
+        slot& self = slots[cpu() % SLOTS];
+        if(!self.busy.test_and_set(std::memory_order_acquire)) {
+            // flush half
+            if(self.count == DEPTH) {
+                std::lock_guard<std::mutex> guard(lock);
+                for(size_t i = 0, loop = DEPTH >> 1; i < loop; ++i) {
+                    void* chunk                      = self.cache[--self.count];
+                    *reinterpret_cast<void**>(chunk) = central;
+                    central                          = chunk;
+                }
+            }
+            bool cached = self.cache != nullptr;
+            if(cached) {
+                self.cache[self.count++] = in;
+            }
+            self.busy.clear(std::memory_order_release);
+            if(cached) {
+                return;
+            }
+        }
+    }
+
+    push(in);
+}
+
+void* percpu::pull() noexcept {
+    std::lock_guard<std::mutex> guard(lock);
+    if(!central && !setup()) {
+        return nullptr;
+    }
+    void* out = central;
+    central   = *reinterpret_cast<void**>(central);
+    return out;
+}
+
+void percpu::push(void* in) noexcept {
+    std::lock_guard<std::mutex> guard(lock);
+    *reinterpret_cast<void**>(in) = central;
+    central                       = in;
+}
+
+bool percpu::setup() noexcept {
+    uint8_t* block = static_cast<uint8_t*>(allocator::malloc(TOTAL, ALIGN));
+    if(!block) {
+        return false;
+    }
+
+    // link to generated blocks by last pointer
+    *reinterpret_cast<uint8_t**>(block + CHUNK * COUNT) = blocks;
+    blocks                                               = block;
+
+    // link chunks, last one is linked to current free list
+    for(size_t i = 0; i < COUNT - 1; ++i) {
+        *reinterpret_cast<void**>(block + CHUNK * i) = block + CHUNK * (i + 1);
+    }
+    *reinterpret_cast<void**>(block + CHUNK * (COUNT - 1)) = central;
+
+    central = block;
+    return true;
+}
+
+} // namespace mem
+} // namespace lwe
@@ -4,6 +4,7 @@
 // #include "queue"
 
 #include "deque.hh"
+#include "mpmc.hh"
 
 /*******************************************************************************
  * pool structure
@@ -24,11 +25,12 @@
  * total: 320 byte (64 + 128 * 2)
  *
  * - block : block header (struct) like node
+ *   ├─[ 8 byte]: parent pool pointer
  *   ├─[ 8 byte]: next chunk pointer
  *   ├─[ 8 byte]: next block pointer
  *   ├─[ 8 byte]: prev block pointer
- *   ├─[ 8 byte]: parent pool pointer
- *   └─[32 byte]: padding
+ *   ├─[ 8 byte]: using chunk count
+ *   └─[24 byte]: padding
  *
  * - chunk: not a struct, abstract object for dynamic chunk size.
  *   ├─[ 8 byte]: parent block address (meta)
@@ -56,6 +58,13 @@ namespace mem {
  *  pool::statics<sizeof(type)>().deconstruct<type>(ptr);     // free
  * @endcode
  *
+ * - tag: segregated blocks for same size, eg. per type or per subsystem.
+ *
+ * @code {.cpp}
+ *  pool::statics<64, 8, 128, struct order_book>(); // not shared with other 64 byte
+ *  pool::statics_for<type>();                      // tag is type
+ * @endcode
+ *
  * 2. create object (NOT THREAD-SAFE)
  *  - NOTE: safe when declared as thread_local.
  *
@@ -76,15 +85,34 @@ namespace mem {
  *
  * - this is for use when the parents are unknown.
  *
+ * - release on the thread of parent statics recycles at once, not by gc.
+ *
+ * - pool destroyed with live chunks (eg. thread end) leaves its blocks to heir.
+ *   heir is freed with the last chunk returned by release() or destruct().
+ *   blocks are redirected to heir first, then releases in progress are waited.
+ *
  * gc (garbage collector)
  * - lock-free queue.
  * - push if parents are different.
  * - gc cleanup is call cleanup(), or call destructe().
  * - used for thread-safety.
+ * - push fails (hard quota, out of memory): chunk is linked to spilled, not dropped.
  *
  * - unused memory can be free by calling cleanup().
  * - call at the right time.
  * - NOTE: it is actual memory deallocate.
+ *
+ * limits (optional)
+ * - limits().set(soft, hard): bytes of blocks in this pool.
+ * - over soft: idle block is freed at once, reclaim callbacks are called.
+ * - over hard: construct returns nullptr when no free chunk.
+ * - quota::global() is also applied: see allocator::malloc.
+ *
+ * maintainer (optional)
+ * - pool of sleeping thread can not drain its gc.
+ * - call attach() on owner thread, then maintainer drains and trims it.
+ * - owner and maintainer hand off by one atomic state, no lock.
+ * - NOTE: owner pays one CAS per call only when attached.
  ******************************************************************************/
 class pool {
 public:
@@ -96,17 +124,38 @@ public:
 private:
     /**
      * @brief memory pool block node
-     * @note  4 pointer = 32 byte in x64
+     * @note  5 pointer = 40 byte in x64
      */
     struct block;
 
+private:
+    /// @brief owner side of handshake, scope
+    struct guard;
+
+private:
+    /// @brief releasing side, scope: destroyed pool waits it after redirecting blocks
+    struct transit;
+
+private:
+    friend class maintainer;
+
 public:
     /**
      * @brief thread-safe static memory pool
      * @note  1. use thread_local, it is thread safe but pool count is same as thread count
      * @note  2. different template parameter result in different types
+     * @note  3. Tag is only for key, different tag is different pool
      */
-    template<size_t Size, size_t Align = config::DEF_ALIGN, size_t Count = config::DEF_CACHE> static pool& statics();
+    template<size_t Size,
+             size_t Align = config::DEF_ALIGN,
+             size_t Count = config::DEF_CACHE,
+             typename Tag = void>
+    static pool& statics();
+
+public:
+    /// @brief statics for type: size and align of T, tag is T
+    /// @note  account tag is 'Tag::account' if exists
+    template<typename T, size_t Count = config::DEF_CACHE, typename Tag = T> static pool& statics_for();
 
 public:
     /**
@@ -115,8 +164,16 @@ public:
      * @param [in] chunk - chunk size, it is padded to the pointer size.
      * @param [in] align - chunk align, it is adjusted to the power of 2.
      * @param [in] count - chunk count in block.
+     * @param [in] tag   - account tag of chunks, default is current scope.
      */
-    pool(size_t chunk, size_t align = config::DEF_ALIGN, size_t count = config::DEF_CACHE) noexcept;
+    pool(size_t chunk,
+         size_t align = config::DEF_ALIGN,
+         size_t count = config::DEF_CACHE,
+         size_t tag   = account::current()) noexcept;
+
+private:
+    /// @brief statics: owner is key of its thread
+    pool(size_t chunk, size_t align, size_t count, size_t tag, const void* owner) noexcept;
 
 public:
     /// @brief destroy the pool object.
@@ -126,6 +183,11 @@ public:
     /// @brief get memory, call malloc when top is null and garbage collector is empty.
     template<typename T = void, typename... Args> T* construct(Args&&...) noexcept;
 
+public:
+    /// @brief get memory from block of hint first, for locality: eg. parent and child.
+    /// @note  same as construct when hint is nullptr, from other pool, or its block is full.
+    template<typename T = void, typename... Args> T* construct_near(const void* hint, Args&&...) noexcept;
+
 public:
     /// @brief return memory, if not child of pool, push to garbage collector of parent pool.
     template<typename T = void> void destruct(T*) noexcept;
@@ -134,6 +196,76 @@ public:
     /// @brief cleaning idle blocks and garbage collector.
     void cleanup() noexcept;
 
+public:
+    /**
+     * @brief move live chunks of sparse blocks into dense blocks, and free emptied blocks.
+     *
+     * @param [in] relocate - callable (void* from, void* to): move object, fix references.
+     *                        'from' is returned to pool after called.
+     * @param [in] sparse   - using ratio of block to be moved: 0 ~ 1.
+     * @return freed block count
+     *
+     * NOTE: opt-in, owner thread only.
+     * NOTE: no other thread may free to this pool while compacting. (gc is drained first)
+     */
+    template<typename F> size_t compact(F&& relocate, float sparse = 0.25f) noexcept;
+
+public:
+    /// @brief account tag of chunks, change before use.
+    void tag(size_t) noexcept;
+
+public:
+    /// @brief account tag of chunks.
+    size_t tag() const noexcept;
+
+public:
+    /// @brief per pool byte limits and reclaim callbacks.
+    quota& limits() noexcept;
+
+public:
+    /// @brief register to maintainer, call on owner thread.
+    void attach() noexcept;
+
+public:
+    /// @brief unregister from maintainer, also called when destroyed.
+    void detach() noexcept;
+
+private:
+    /// @brief garbage collector to blocks.
+    /// @return recycled chunk count
+    size_t drain() noexcept;
+
+private:
+    /// @brief link chunk to spilled when gc push fails (hard quota or out of memory)
+    void spill(void*) noexcept;
+
+private:
+    /// @brief spilled to blocks
+    /// @return recycled chunk count
+    size_t salvage() noexcept;
+
+private:
+    /// @brief return chunks of parent: recycled at once on owner thread, else gc.
+    static void give(pool* parent, void** in, size_t count) noexcept;
+
+private:
+    /// @brief key of calling thread, owner of its statics
+    static const void* caller() noexcept;
+
+private:
+    /// @brief move blocks of live chunks to heir, called when destroyed.
+    /// @return false: no live chunk or failed to allocate heir
+    bool inherit() noexcept;
+
+private:
+    /// @brief heir: chunks are returned, delete self at last.
+    void bury(size_t count) noexcept;
+
+private:
+    /// @brief free idle blocks except 'keep'.
+    /// @return freed block count
+    size_t trim(size_t keep) noexcept;
+
 private:
     /// @brief call memory allocate function.
     block* setup() noexcept;
@@ -142,10 +274,54 @@ private:
     /// @brief chunk to block.
     void recycle(void*) noexcept;
 
+private:
+    /// @brief remove from usable block list.
+    void unlink(block*) noexcept;
+
+private:
+    /// @brief sort usable block list by used, densest first: merge sort on links.
+    /// @return new head, prev is relinked
+    static block* order(block*) noexcept;
+
+private:
+    /// @brief tag meta of free chunks in block, low bit of parent pointer: compact only.
+    static void mark(block*, bool) noexcept;
+    static bool marked(const void*) noexcept;
+
+private:
+    /// @brief actual block deallocate.
+    void remove(block*) noexcept;
+
 public:
     /// @brief auto return memory to parent pool
     template<typename T = void> static void release(T*) noexcept;
 
+public:
+    /// @brief auto return destroyed chunks, same parent run is enqueued at once
+    static void release(void**, size_t) noexcept;
+
+public:
+    /// @brief pool pointer info, see lookup()
+    struct info {
+        pool*  from;   // parent pool
+        size_t usable; // writable bytes, include padding
+        size_t chunk;  // size class: chunk with meta
+        size_t align;  // chunk align
+    };
+
+private:
+    friend info lookup(const void*) noexcept;
+
+public:
+    /// @brief chunk is from this pool: O(1), block of meta is range checked first
+    /// @note  any readable pointer, word before it is read
+    bool owns(const void*) const noexcept;
+
+public:
+    /// @brief writable bytes of chunk, can be larger than requested by padding
+    /// @note  pointer must be from any pool
+    static size_t usable_size(const void*) noexcept;
+
 private:
     const size_t ALIGN;
     const size_t BLOCK;
@@ -166,10 +342,79 @@ private:
     std::unordered_set<block*> all;
 
 private:
-    /// @brief temp lock-free queue for windows
-    moodycamel::ConcurrentQueue<void*> gc;
+    /// @brief block bytes of this pool
+    quota budget;
+
+private:
+    /// @brief account tag
+    size_t tagged;
+
+private:
+    /// @brief account tag of statics Tag type
+    template<typename Tag, typename = void> struct labeled {
+        static size_t get() noexcept { return account::current(); }
+    };
+    template<typename Tag> struct labeled<Tag, std::void_t<decltype(Tag::account)>> {
+        static size_t get() noexcept { return Tag::account; }
+    };
+
+private:
+    /// @brief lock-free queue, chunks from other threads
+    data::mpmc_queue<void*> gc;
+
+private:
+    /// @brief lock-free stack linked by chunk, when gc failed to allocate
+    std::atomic<void*> spilled = nullptr;
+
+private:
+    /// @brief thread of statics, nullptr: any thread
+    const void* owner;
+
+private:
+    /// @brief heir of destroyed pool: live chunk count, locked by graveyard()
+    /// @note  heir is set before blocks are redirected to it, read after
+    bool   heir    = false;
+    size_t orphans = 0;
+
+private:
+    /// @brief handshake state
+    enum : uint8_t {
+        E_FREE,
+        E_OWNER,
+        E_SERVICE,
+    };
+    std::atomic<uint8_t> state  = E_FREE;
+    std::atomic<bool>    shared = false;
+
+public:
+    /// @brief published by maintainer
+    struct stats {
+        size_t blocks;  // generated
+        size_t idle;    // fully unused
+        size_t drained; // gc chunks recycled, last pass
+        size_t trimmed; // blocks freed, total
+    };
+
+private:
+    stats report = {};
+
+private:
+    /// @brief attached pools
+    static std::unordered_set<pool*>& registry() noexcept;
+    static std::mutex&                locker() noexcept;
+
+private:
+    /// @brief heirs
+    static std::mutex& graveyard() noexcept;
 };
 
+/**
+ * @brief  parent pool and size class of chunk: O(1), read meta only
+ * @note   pointer must be from any pool
+ * @return nullptr: all zero
+ */
+pool::info lookup(const void*) noexcept;
+
 } // namespace mem
 } // namespace lwe
 
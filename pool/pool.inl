@@ -10,18 +10,107 @@ struct pool::block {
 
     static block* find(void*) noexcept;
 
-    pool*  from;
-    void*  curr;
-    block* next;
-    block* prev;
+    std::atomic<pool*> from; // redirected to heir when destroyed
+    void*              curr;
+    block*             next;
+    block*             prev;
+    size_t             used;
+};
+
+struct pool::guard {
+    guard(pool* in) noexcept: self(in), on(in->shared.load(std::memory_order_relaxed)), prev(chain()) {
+        if(on) {
+            // wait maintainer
+            uint8_t expect = E_FREE;
+            while(!self->state.compare_exchange_weak(expect, E_OWNER, std::memory_order_acquire)) {
+                expect = E_FREE;
+                std::this_thread::yield();
+            }
+        }
+        chain() = this;
+    }
+    ~guard() noexcept {
+        chain() = prev;
+        if(on) {
+            self->state.store(E_FREE, std::memory_order_release);
+        }
+    }
+
+    /// @brief pool is guarded by this thread: not reentrant, do not wait it
+    static bool held(const pool* in) noexcept {
+        for(guard* i = chain(); i; i = i->prev) {
+            if(i->self == in) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief guards of this thread, innermost first
+    static guard*& chain() noexcept {
+        static thread_local guard* head = nullptr;
+        return head;
+    }
+
+    pool*  self;
+    bool   on;
+    guard* prev;
+};
+
+struct pool::transit {
+    transit() noexcept: lane(lanes()[index()]) {
+        lane.count.fetch_add(1, std::memory_order_seq_cst);
+        ++depth();
+    }
+    ~transit() noexcept {
+        --depth();
+        lane.count.fetch_sub(1, std::memory_order_release);
+    }
+
+    /// @brief wait threads that read 'from' before it was redirected, but own lane
+    static void settle() noexcept {
+        size_t self = index();
+        for(size_t i = 0; i < LANES; ++i) {
+            size_t held = i == self ? depth() : 0;
+            while(lanes()[i].count.load(std::memory_order_seq_cst) > held) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    struct alignas(64) counter {
+        std::atomic<size_t> count;
+    };
+
+    static constexpr size_t LANES = 64;
+
+    /// @brief round robin: threads are spread over lanes
+    static size_t index() noexcept {
+        static std::atomic<size_t> serial{ 0 };
+        static thread_local size_t lane = serial.fetch_add(1, std::memory_order_relaxed) % LANES;
+        return lane;
+    }
+
+    static size_t& depth() noexcept {
+        static thread_local size_t nested = 0;
+        return nested;
+    }
+
+    static counter* lanes() noexcept {
+        static counter instance[LANES] = {};
+        return instance;
+    }
+
+    counter& lane;
 };
 
 void pool::block::initialize(pool* parent, size_t count) noexcept {
-    from = parent;
+    from.store(parent, std::memory_order_relaxed);
     next = nullptr;
     prev = nullptr;
+    used = 0;
 
-    uint8_t* data = reinterpret_cast<uint8_t*>(this) + from->BLOCK; // pass header
+    uint8_t* data = reinterpret_cast<uint8_t*>(this) + parent->BLOCK; // pass header
     uint8_t* meta = data - sizeof(void*);                           // pass pointer
 
     curr = reinterpret_cast<void*>(data); // save
@@ -30,10 +119,10 @@ void pool::block::initialize(pool* parent, size_t count) noexcept {
     size_t loop = count - 1;
     for(size_t i = 0; i < loop; ++i) {
         *reinterpret_cast<void**>(meta) = reinterpret_cast<void*>(this);               // parent
-        *reinterpret_cast<void**>(data) = reinterpret_cast<void*>(data + from->CHUNK); // next
+        *reinterpret_cast<void**>(data) = reinterpret_cast<void*>(data + parent->CHUNK); // next
 
-        meta += from->CHUNK;
-        data += from->CHUNK;
+        meta += parent->CHUNK;
+        data += parent->CHUNK;
     }
 
     *reinterpret_cast<void**>(meta) = reinterpret_cast<void*>(this);
@@ -50,6 +139,7 @@ void* pool::block::get() noexcept {
 
     // set next
     curr = *reinterpret_cast<void**>(curr);
+    ++used;
 
     return out;
 }
@@ -61,6 +151,7 @@ void pool::block::set(void* in) noexcept {
     *(reinterpret_cast<void**>(in)) = curr;
 
     curr = in;
+    --used;
 }
 
 auto pool::block::find(void* in) noexcept -> block* {
@@ -69,70 +160,151 @@ auto pool::block::find(void* in) noexcept -> block* {
 }
 
 // clang-format off
-pool::pool(size_t chunk, size_t align, size_t count) noexcept :
+pool::pool(size_t chunk, size_t align, size_t count, size_t tag) noexcept :
+    pool(chunk, align, count, tag, nullptr)
+{}
+
+pool::pool(size_t chunk, size_t align, size_t count, size_t tag, const void* thread) noexcept :
     ALIGN{ util::aligner::boundary(align) },
     BLOCK{ util::aligner::padding(sizeof(block) + sizeof(void*), ALIGN) },
     CHUNK{ util::aligner::padding(chunk + sizeof(void*), ALIGN) },
     COUNT{ util::aligner::padding(count, config::DEF_CACHE) },
-    TOTAL{ BLOCK + (CHUNK * COUNT) }
+    TOTAL{ BLOCK + (CHUNK * COUNT) },
+    tagged{ tag },
+    owner{ thread }
 {}
 //clang-format on
 
 pool::~pool() noexcept {
+    account::scope internal(account::NONE);
+    detach();
+
+    // live chunks: their blocks outlive this
+    if(!heir && inherit()) {
+        return;
+    }
+
     for(auto i = all.begin(); i != all.end(); ++i) {
         allocator::free(*i);
     }
 }
 
 auto pool::setup() noexcept->block* {
+    account::scope internal(account::NONE);
+
+    // over hard
+    if(!budget.charge(TOTAL)) {
+        return nullptr;
+    }
     if(block* self = static_cast<block*>(allocator::malloc(TOTAL, ALIGN))) {
         self->initialize(this, COUNT);
         all.insert(self);
         return self;
     }
+    budget.uncharge(TOTAL);
     return nullptr;
 }
 
-template<size_t Size, size_t Align, size_t Count> pool& pool::statics() {
-    static thread_local pool instance(Size, Align, Count);
+void pool::remove(block* in) noexcept {
+    account::scope internal(account::NONE);
+    all.erase(in);
+    allocator::free(in);
+    budget.uncharge(TOTAL);
+}
+
+void pool::tag(size_t in) noexcept {
+    tagged = in;
+}
+
+size_t pool::tag() const noexcept {
+    return tagged;
+}
+
+quota& pool::limits() noexcept {
+    return budget;
+}
+
+template<size_t Size, size_t Align, size_t Count, typename Tag> pool& pool::statics() {
+    static thread_local pool instance(Size, Align, Count, labeled<Tag>::get(), caller());
     return instance;
 }
 
+template<typename T, size_t Count, typename Tag> pool& pool::statics_for() {
+    return statics<sizeof(T), alignof(T), Count, Tag>();
+}
+
 template<typename T, typename... Args> inline T* pool::construct(Args&&... args) noexcept {
     void* ptr = nullptr;
-    
-    // check has block
-    if(!top) {
-        if(idle.size()) {
-            idle.fifo(&top);
+
+    // owner section: not call constructor in here
+    {
+        guard lock(this);
+
+        // check has block
+        if(!top) {
+            if(idle.size()) {
+                idle.fifo(&top);
+            }
+
+            // check has chunk in garbage collector, or spilled from it
+            else if (gc.pop(&ptr) == false && salvage() == 0) {
+                top = setup();
+            }
+        }
+
+        // EXCEPTION
+        if (!top && !ptr) {
+            return nullptr;
         }
-        
-        // check has chunk in garbage collector
-        else if (gc.try_dequeue(ptr) == false) {
-            top = setup();
+
+        // if got => pass
+        if (ptr == nullptr) {
+            ptr = top->get();
+            if(top->curr == nullptr) {
+                if(top->next) {
+                    top             = top->next; // next
+                    top->prev->next = nullptr;   // unlink
+                    top->prev       = nullptr;   // unlink
+                }
+
+                // not leak
+                else top = nullptr;
+            }
         }
     }
+    account::add(tagged, CHUNK, 1);
 
-    // EXCEPTION
-    if (!top && !ptr) {
-        return nullptr;
+    // return
+    T* ret = reinterpret_cast<T*>(ptr);
+    if constexpr(!std::is_pointer_v<T> && !std::is_same_v<T, void>) {
+        new(ret) T({ std::forward<Args>(args)... }); // new
     }
+    return ret;
+}
 
-    // if got => pass
-    if (ptr == nullptr) {
-        ptr = top->get();
-        if(top->curr == nullptr) {
-            if(top->next) {
-                top             = top->next; // next
-                top->prev->next = nullptr;   // unlink
-                top->prev       = nullptr;   // unlink
-            }
+template<typename T, typename... Args> T* pool::construct_near(const void* hint, Args&&... args) noexcept {
+    void* ptr = nullptr;
 
-            // not leak
-            else top = nullptr;
+    // owner section: not call constructor in here
+    if(hint) {
+        guard lock(this);
+
+        block* near = block::find(const_cast<void*>(hint));
+        if(near->from.load(std::memory_order_relaxed) == this && near->curr) {
+            ptr = near->get();
+
+            // full: it was in usable list
+            if(near->curr == nullptr) {
+                unlink(near);
+            }
         }
     }
 
+    if(!ptr) {
+        return construct<T>(std::forward<Args>(args)...);
+    }
+    account::add(tagged, CHUNK, 1);
+
     // return
     T* ret = reinterpret_cast<T*>(ptr);
     if constexpr(!std::is_pointer_v<T> && !std::is_same_v<T, void>) {
@@ -150,43 +322,217 @@ void pool::destruct(T* in) noexcept {
         in->~T();
     }
 
-    // if from this
-    pool* self = block::find(in)->from;
-    if(this == self) {
+    guard lock(this);
+
+    // if from this: not redirected while this is alive
+    block* parent = block::find(in);
+    if(parent->from.load(std::memory_order_relaxed) == this) {
+        account::add(tagged, -int64_t(CHUNK), -1);
         recycle(in);
     }
 
     // to correct pool
-    else self->gc.enqueue(in);
+    else {
+        transit pass;
+        void*   ptr = in;
+        give(parent->from.load(std::memory_order_seq_cst), &ptr, 1);
+    }
 
     // from other pools
-    while(gc.try_dequeue(in)) {
-        recycle(in);
-    }
+    drain();
 }
 
 void pool::cleanup() noexcept {
-    void* garbage;
-    while(gc.try_dequeue(garbage)) {
-        block::find(garbage)->set(garbage); // child blocks
-        (*reinterpret_cast<block**>(reinterpret_cast<void**>(garbage) - 1))->set(garbage);
+    guard lock(this);
+    drain();
+    trim(0);
+}
+
+size_t pool::drain() noexcept {
+    size_t count = 0;
+    void*  garbage[config::DEF_CACHE];
+    while(size_t got = gc.pop(garbage, config::DEF_CACHE)) {
+        for(size_t i = 0; i < got; ++i) {
+            recycle(garbage[i]);
+        }
+        count += got;
     }
+    return count + salvage();
+}
 
-    while(idle.size()) {
+void pool::spill(void* in) noexcept {
+    void* head = spilled.load(std::memory_order_relaxed);
+    do {
+        *reinterpret_cast<void**>(in) = head;
+    } while(!spilled.compare_exchange_weak(head, in, std::memory_order_release, std::memory_order_relaxed));
+}
+
+size_t pool::salvage() noexcept {
+    size_t count = 0;
+    void*  list  = spilled.exchange(nullptr, std::memory_order_acquire);
+    while(list) {
+        void* next = *reinterpret_cast<void**>(list); // overwritten by recycle
+        recycle(list);
+        list = next;
+        ++count;
+    }
+    return count;
+}
+
+size_t pool::trim(size_t keep) noexcept {
+    size_t count = 0;
+    while(idle.size() > keep) {
         block* ptr = nullptr;
         idle.fifo(&ptr);
         if(ptr) {
-            all.erase(ptr);
-            allocator::free(ptr);
+            remove(ptr);
+            ++count;
+        }
+    }
+    return count;
+}
+
+void pool::attach() noexcept {
+    std::lock_guard<std::mutex> lock(locker());
+    if(registry().insert(this).second) {
+        shared.store(true, std::memory_order_relaxed);
+    }
+}
+
+void pool::detach() noexcept {
+    if(!shared.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // maintainer holds lock while servicing
+    std::lock_guard<std::mutex> lock(locker());
+    registry().erase(this);
+    shared.store(false, std::memory_order_relaxed);
+}
+
+std::unordered_set<pool*>& pool::registry() noexcept {
+    static std::unordered_set<pool*> instance;
+    return instance;
+}
+
+std::mutex& pool::locker() noexcept {
+    static std::mutex instance;
+    return instance;
+}
+
+// not destroyed: heirs can be buried by other static destructors
+std::mutex& pool::graveyard() noexcept {
+    static std::mutex* instance = new std::mutex();
+    return *instance;
+}
+
+void pool::give(pool* parent, void** in, size_t count) noexcept {
+    account::add(parent->tagged, -int64_t(parent->CHUNK * count), -int64_t(count));
+
+    // parent is destroyed
+    if(parent->heir) {
+        parent->bury(count);
+        return;
+    }
+
+    // statics of this thread: no gc round trip, unless guarded below (eg. reclaim callback)
+    if(parent->owner == caller() && !guard::held(parent)) {
+        guard lock(parent);
+        for(size_t i = 0; i < count; ++i) {
+            parent->recycle(in[i]);
         }
+        return;
+    }
+
+    // lock-free, gc can not allocate block: link by chunk
+    size_t pushed = parent->gc.push(in, count);
+    for(size_t i = pushed; i < count; ++i) {
+        parent->spill(in[i]);
     }
 }
 
+const void* pool::caller() noexcept {
+    static thread_local char key;
+    return &key;
+}
+
+bool pool::inherit() noexcept {
+    drain();
+
+    size_t live = 0;
+    for(block* i : all) {
+        live += i->used;
+    }
+
+    // no chunk is out, but a push to gc may not be returned yet
+    pool* next = live ? new(std::nothrow) pool(CHUNK - sizeof(void*), ALIGN, COUNT, tagged) : nullptr;
+    if(!next) {
+        transit::settle();
+        return false;
+    }
+
+    // redirect: give after this buries to next, before this is waited
+    next->heir = true;
+    for(block* i : all) {
+        i->from.store(next, std::memory_order_seq_cst);
+    }
+    transit::settle();
+    drain();
+
+    // empty blocks are freed now
+    live = 0;
+    for(auto i = all.begin(); i != all.end();) {
+        if((*i)->used == 0) {
+            allocator::free(*i);
+            i = all.erase(i);
+        } else {
+            live += (*i)->used;
+            ++i;
+        }
+    }
+    next->all.swap(all);
+
+    // buried before this are subtracted already: wraps until live is added
+    bool last = false;
+    {
+        std::lock_guard<std::mutex> lock(graveyard());
+        next->orphans += live;
+        last           = next->orphans == 0;
+    }
+    if(last) {
+        delete next;
+    }
+    return true;
+}
+
+void pool::bury(size_t count) noexcept {
+    {
+        std::lock_guard<std::mutex> lock(graveyard());
+        orphans -= count;
+        if(orphans) {
+            return;
+        }
+    }
+    delete this; // last chunk: no other reference
+}
+
 void pool::recycle(void* in) noexcept {
     block* parent = block::find(in);
 
     // empty -> usable
     if(parent->curr == nullptr) {
+        // kept top is unused: to idle
+        if(top && top->used == 0) {
+            block* old = top;
+            top        = old->next;
+            if(top) {
+                top->prev = nullptr;
+            }
+            old->next = nullptr;
+            if(budget.exceeded()) {
+                remove(old);
+            } else idle.push(old);
+        }
         if(top) {
             top->prev = parent;
         }
@@ -199,31 +545,192 @@ void pool::recycle(void* in) noexcept {
     parent->set(in);
 
     // using -> full
-    if(parent->curr == static_cast<void*>(parent + 1)) {
+    if(parent->used == 0) {
         if(parent == top) {
             return; // keep
         }
-        if(parent->next) {
-            parent->next->prev = parent->prev;
-            parent->next       = nullptr;
+        unlink(parent);
+
+        // over soft: not keep
+        if(budget.exceeded()) {
+            remove(parent);
+        } else idle.push(parent);
+    }
+}
+
+template<typename F> size_t pool::compact(F&& relocate, float sparse) noexcept {
+    guard lock(this);
+    drain();
+
+    // usable blocks: densest first, sparsest last
+    top = order(top);
+
+    block* dst = top;
+    block* src = top;
+    while(src && src->next && src->next->used) {
+        src = src->next; // unused top is kept
+    }
+
+    // filled blocks are a prefix of list: unlink them
+    auto finish = [this]() noexcept {
+        while(top && top->curr == nullptr) {
+            unlink(top);
         }
-        if(parent->prev) {
-            parent->prev->next = parent->next;
-            parent->prev       = nullptr;
+    };
+
+    size_t freed = 0;
+    size_t limit = size_t(COUNT * sparse);
+    while(src != dst && src->used && src->used <= limit) {
+        block*   prev = src->prev;
+        uint8_t* data = reinterpret_cast<uint8_t*>(src) + BLOCK;
+        mark(src, true);
+
+        // move live chunks
+        for(size_t i = 0; i < COUNT && src->used; ++i) {
+            void* in = data + (i * CHUNK);
+            if(marked(in)) {
+                continue;
+            }
+
+            // find destination
+            while(dst != src && dst->curr == nullptr) {
+                dst = dst->next;
+            }
+            if(dst == src) {
+                mark(src, false);
+                finish();
+                return freed;
+            }
+
+            void* out = dst->get();
+            relocate(in, out);
+            src->set(in);
         }
-        idle.push(parent);
+
+        // emptied
+        unlink(src);
+        remove(src);
+        ++freed;
+        src = prev;
+    }
+    finish();
+    return freed;
+}
+
+auto pool::order(block* head) noexcept -> block* {
+    if(!head || !head->next) {
+        return head;
+    }
+
+    // split at middle
+    block* slow = head;
+    block* fast = head->next;
+    while(fast && fast->next) {
+        slow = slow->next;
+        fast = fast->next->next;
+    }
+    block* back = slow->next;
+    slow->next  = nullptr;
+
+    // merge, prev is relinked
+    block*  l    = order(head);
+    block*  r    = order(back);
+    block*  out  = nullptr;
+    block** tail = &out;
+    block*  prev = nullptr;
+    while(l || r) {
+        block*& pick = (!r || (l && l->used >= r->used)) ? l : r;
+        block*  node = pick;
+        pick         = node->next;
+        node->prev   = prev;
+        *tail        = node;
+        tail         = &node->next;
+        prev         = node;
+    }
+    *tail = nullptr;
+    return out;
+}
+
+void pool::mark(block* in, bool on) noexcept {
+    for(void* i = in->curr; i; i = *reinterpret_cast<void**>(i)) {
+        uintptr_t* meta = reinterpret_cast<uintptr_t*>(i) - 1;
+        *meta           = on ? (*meta | 1) : (*meta & ~uintptr_t(1));
+    }
+}
+
+bool pool::marked(const void* in) noexcept {
+    return *(reinterpret_cast<const uintptr_t*>(in) - 1) & 1;
+}
+
+void pool::unlink(block* in) noexcept {
+    if(in == top) {
+        top = in->next;
     }
+    if(in->next) {
+        in->next->prev = in->prev;
+    }
+    if(in->prev) {
+        in->prev->next = in->next;
+    }
+    in->next = nullptr;
+    in->prev = nullptr;
 }
 
 template<typename T> void pool::release(T* in) noexcept {
-    uint8_t* ptr = reinterpret_cast<uint8_t*>(in) - sizeof(void*);
+    if(!in) return;
 
-    pool* parent = (*reinterpret_cast<block**>(ptr))->from;
     // delete
     if constexpr(!std::is_pointer_v<T> && !std::is_void_v<T>) {
         in->~T();
     }
-    parent->gc.enqueue(in); // lock-free
+
+    // parent is alive while in transit
+    transit pass;
+    void*   ptr    = const_cast<void*>(static_cast<const void*>(in));
+    pool*   parent = block::find(ptr)->from.load(std::memory_order_seq_cst);
+    give(parent, &ptr, 1);
+}
+
+void pool::release(void** in, size_t count) noexcept {
+    transit pass;
+    for(size_t i = 0; i < count;) {
+        pool*  parent = block::find(in[i])->from.load(std::memory_order_seq_cst);
+        size_t j      = i + 1;
+        while(j < count && block::find(in[j])->from.load(std::memory_order_seq_cst) == parent) {
+            ++j;
+        }
+        give(parent, in + i, j - i);
+        i = j;
+    }
+}
+
+bool pool::owns(const void* in) const noexcept {
+    if(!in) {
+        return false;
+    }
+
+    // block of meta: chunk must be in its range before the header is read
+    const uint8_t* ptr  = static_cast<const uint8_t*>(in);
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(block::find(const_cast<void*>(in)));
+    if(ptr < base + BLOCK || ptr >= base + TOTAL || size_t(ptr - base - BLOCK) % CHUNK != 0) {
+        return false;
+    }
+    return reinterpret_cast<const block*>(base)->from.load(std::memory_order_relaxed) == this;
+}
+
+size_t pool::usable_size(const void* in) noexcept {
+    if(!in) {
+        return 0;
+    }
+    return block::find(const_cast<void*>(in))->from.load(std::memory_order_acquire)->CHUNK - sizeof(void*);
+}
+
+pool::info lookup(const void* in) noexcept {
+    if(!in) {
+        return {};
+    }
+    pool* from = pool::block::find(const_cast<void*>(in))->from.load(std::memory_order_acquire);
+    return { from, from->CHUNK - sizeof(void*), from->CHUNK, from->ALIGN };
 }
 
 } // namespace mem
@@ -0,0 +1,97 @@
+#ifndef LWE_PRESSURE_HEADER
+#define LWE_PRESSURE_HEADER
+
+#include "maintainer.hh"
+
+#include <cstdio>
+#include <cstring>
+
+namespace lwe {
+namespace mem {
+
+/*******************************************************************************
+ * memory pressure watcher (linux)
+ *
+ * source
+ *  - E_PSI    : /proc/pressure/memory,        "some avg10" >= threshold (%)
+ *  - E_EVENTS : /sys/fs/cgroup/memory.events, "high" or "max" count increased
+ *  - E_CURRENT: /sys/fs/cgroup/memory.current, bytes >= threshold
+ *
+ * when triggered
+ *  - quota::global().reclaim(): user callbacks and maintainer::tick(),
+ *    so attached pools drain gc and free idle blocks.
+ *
+ * how to use
+ *
+ * @code {.cpp}
+ *  pressure psi(pressure::E_PSI, 10.0);              // 10% stalled
+ *  pressure cgroup(pressure::E_CURRENT, 512 << 20); // 512MB used
+ *  psi.start(std::chrono::milliseconds(500));
+ * @endcode
+ *
+ * - threshold has no default: its unit is of source.
+ * - path can be any file of same format: for test, write stand-in file
+ *   and call poll().
+ ******************************************************************************/
+class pressure {
+public:
+    pressure(const pressure&)            = delete;
+    pressure& operator=(const pressure&) = delete;
+    pressure(pressure&&)                 = delete;
+    pressure& operator=(pressure&&)      = delete;
+
+public:
+    enum source {
+        E_PSI,
+        E_EVENTS,
+        E_CURRENT,
+    };
+
+public:
+    /**
+     * @param [in] kind      - file format.
+     * @param [in] threshold - E_PSI: avg10 percent, E_CURRENT: bytes, E_EVENTS: unused.
+     * @param [in] path      - nullptr is default path of kind.
+     */
+    pressure(source kind, double threshold, const char* path = nullptr);
+
+public:
+    /// @brief stop thread
+    ~pressure() noexcept;
+
+public:
+    /// @brief read once, reclaim when triggered
+    /// @return true: triggered
+    bool poll() noexcept;
+
+public:
+    /// @brief start background polling, restart when running
+    void start(std::chrono::milliseconds period);
+
+public:
+    /// @brief stop background thread and join
+    void stop() noexcept;
+
+private:
+    /// @brief read source file
+    /// @return false: failed to read
+    bool read(double*) noexcept;
+
+private:
+    const source KIND;
+    const double THRESHOLD;
+    char         path[256];
+
+private:
+    /// @brief last value of E_EVENTS
+    double last = 0;
+
+private:
+    util::ticker loop;
+};
+
+} // namespace mem
+} // namespace lwe
+
+#include "pressure.inl"
+#endif
@@ -0,0 +1,111 @@
+#include "pressure.hh"
+
+namespace lwe {
+namespace mem {
+
+// clang-format off
+pressure::pressure(source kind, double threshold, const char* in) :
+    KIND{ kind },
+    THRESHOLD{ threshold }
+{
+    if(!in) {
+        switch(kind) {
+            case E_PSI:     in = "/proc/pressure/memory";         break;
+            case E_EVENTS:  in = "/sys/fs/cgroup/memory.events";  break;
+            case E_CURRENT: in = "/sys/fs/cgroup/memory.current"; break;
+        }
+    }
+    std::strncpy(path, in, sizeof(path) - 1);
+    path[sizeof(path) - 1] = 0;
+
+    // baseline: count before watching is not pressure
+    if(KIND == E_EVENTS && !read(&last)) {
+        last = 0;
+    }
+}
+// clang-format on
+
+pressure::~pressure() noexcept {
+    stop();
+}
+
+bool pressure::read(double* out) noexcept {
+    FILE* file = std::fopen(path, "r");
+    if(!file) {
+        return false;
+    }
+
+    bool   found = false;
+    char   key[64];
+    double value = 0;
+
+    switch(KIND) {
+        // some avg10=0.00 avg60=0.00 avg300=0.00 total=0
+        case E_PSI:
+            while(std::fscanf(file, "%63s", key) == 1) {
+                if(std::strcmp(key, "some") == 0 && std::fscanf(file, " avg10=%lf", &value) == 1) {
+                    found = true;
+                    break;
+                }
+            }
+            break;
+
+        // low 0 \n high 0 \n max 0 \n oom 0 \n oom_kill 0
+        case E_EVENTS:
+            while(std::fscanf(file, "%63s %lf", key, &value) == 2) {
+                if(std::strcmp(key, "high") == 0 || std::strcmp(key, "max") == 0) {
+                    *out  = found ? *out + value : value;
+                    found = true;
+                }
+            }
+            std::fclose(file);
+            return found;
+
+        // bytes
+        case E_CURRENT:
+            found = std::fscanf(file, "%lf", &value) == 1;
+            break;
+    }
+
+    std::fclose(file);
+    if(found) {
+        *out = value;
+    }
+    return found;
+}
+
+bool pressure::poll() noexcept {
+    double value = 0;
+    if(!read(&value)) {
+        return false;
+    }
+
+    bool triggered = false;
+    switch(KIND) {
+        case E_PSI:
+        case E_CURRENT:
+            triggered = value >= THRESHOLD;
+            break;
+        case E_EVENTS:
+            triggered = value > last;
+            last      = value;
+            break;
+    }
+
+    if(triggered) {
+        maintainer::instance(); // register reclaimer
+        quota::global().reclaim();
+    }
+    return triggered;
+}
+
+void pressure::start(std::chrono::milliseconds period) {
+    loop.start(period, [this] { poll(); });
+}
+
+void pressure::stop() noexcept {
+    loop.stop();
+}
+
+} // namespace mem
+} // namespace lwe
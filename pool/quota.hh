@@ -0,0 +1,99 @@
+#ifndef LWE_QUOTA_HEADER
+#define LWE_QUOTA_HEADER
+
+#include "config.hh"
+
+#include <vector>
+#include <functional>
+
+namespace lwe {
+namespace mem {
+
+/*******************************************************************************
+ * byte limits and reclaim callbacks
+ *
+ * - global: charged by allocator::malloc, uncharged by allocator::free.
+ * - pool  : charged by pool::setup, uncharged when block is freed.
+ *
+ * ────────────────┬──────────────┬──────────────> usage
+ *                 soft           hard
+ *                 └ reclaim      └ charge fails: malloc / construct returns nullptr
+ *
+ * reclaim
+ * - called by the charge that crosses soft, not by later charges over soft.
+ * - user callbacks: drop caches, etc.
+ * - pool: does not keep idle blocks over soft, frees it at once.
+ * - maintainer: trims attached pools when global soft is crossed.
+ * - one thread reclaims at a time, nested charge does not reclaim again.
+ * - callbacks are called under lock: attach / detach in callback deadlocks.
+ * - charge in pool can reclaim while its guard is held: that pool is skipped.
+ * - hard: reclaim once and retry before fail.
+ *
+ * NOTE: 0 is unlimited.
+ ******************************************************************************/
+class quota {
+public:
+    quota(const quota&)            = delete;
+    quota& operator=(const quota&) = delete;
+    quota(quota&&)                 = delete;
+    quota& operator=(quota&&)      = delete;
+
+public:
+    quota(size_t soft = 0, size_t hard = 0) noexcept;
+
+public:
+    /// @brief process wide quota, used by allocator::malloc
+    static quota& global() noexcept;
+
+public:
+    /// @brief set limits, 0 is unlimited
+    void set(size_t soft, size_t hard) noexcept;
+
+public:
+    /// @brief add usage
+    /// @return false: over hard after reclaim, not charged
+    bool charge(size_t) noexcept;
+
+public:
+    /// @brief sub usage
+    void uncharge(size_t) noexcept;
+
+public:
+    /// @brief current charged bytes
+    size_t usage() const noexcept;
+
+public:
+    /// @brief usage is over soft limit
+    bool exceeded() const noexcept;
+
+public:
+    /// @brief add reclaim callback
+    /// @return id for detach
+    size_t attach(std::function<void()>);
+
+public:
+    /// @brief remove reclaim callback
+    void detach(size_t) noexcept;
+
+public:
+    /// @brief call reclaim callbacks
+    /// @return false: other thread is reclaiming
+    bool reclaim() noexcept;
+
+private:
+    std::atomic<size_t> soft;
+    std::atomic<size_t> hard;
+    std::atomic<size_t> used;
+    std::atomic<bool>   busy;
+
+private:
+    std::mutex                                            lock;
+    std::vector<std::pair<size_t, std::function<void()>>> callbacks;
+    size_t                                                serial = 0;
+};
+
+} // namespace mem
+} // namespace lwe
+
+#include "quota.inl"
+#endif
@@ -0,0 +1,96 @@
+#include "quota.hh"
+
+namespace lwe {
+namespace mem {
+
+quota::quota(size_t soft_, size_t hard_) noexcept {
+    soft.store(soft_, std::memory_order_relaxed);
+    hard.store(hard_, std::memory_order_relaxed);
+    used.store(0, std::memory_order_relaxed);
+    busy.store(false, std::memory_order_relaxed);
+}
+
+quota& quota::global() noexcept {
+    static quota instance;
+    return instance;
+}
+
+void quota::set(size_t soft_, size_t hard_) noexcept {
+    soft.store(soft_, std::memory_order_relaxed);
+    hard.store(hard_, std::memory_order_relaxed);
+}
+
+bool quota::charge(size_t in) noexcept {
+    size_t limit = hard.load(std::memory_order_relaxed);
+    size_t prev  = used.fetch_add(in, std::memory_order_relaxed);
+
+    // over hard: reclaim once and retry
+    if(limit && prev + in > limit) {
+        used.fetch_sub(in, std::memory_order_relaxed);
+        if(!reclaim()) {
+            return false;
+        }
+        prev = used.fetch_add(in, std::memory_order_relaxed);
+        if(prev + in > limit) {
+            used.fetch_sub(in, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    // crossing soft: once, not on every charge over it
+    limit = soft.load(std::memory_order_relaxed);
+    if(limit && prev <= limit && prev + in > limit) {
+        reclaim();
+    }
+    return true;
+}
+
+void quota::uncharge(size_t in) noexcept {
+    used.fetch_sub(in, std::memory_order_relaxed);
+}
+
+size_t quota::usage() const noexcept {
+    return used.load(std::memory_order_relaxed);
+}
+
+bool quota::exceeded() const noexcept {
+    size_t limit = soft.load(std::memory_order_relaxed);
+    return limit && used.load(std::memory_order_relaxed) > limit;
+}
+
+size_t quota::attach(std::function<void()> in) {
+    std::lock_guard<std::mutex> guard(lock);
+    callbacks.emplace_back(++serial, std::move(in));
+    return serial;
+}
+
+void quota::detach(size_t id) noexcept {
+    std::lock_guard<std::mutex> guard(lock);
+    for(auto i = callbacks.begin(); i != callbacks.end(); ++i) {
+        if(i->first == id) {
+            callbacks.erase(i);
+            return;
+        }
+    }
+}
+
+bool quota::reclaim() noexcept {
+    // nested or other thread
+    if(busy.exchange(true, std::memory_order_acquire)) {
+        return false;
+    }
+
+    // no copy: callback must not attach / detach
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        for(auto& callback : callbacks) {
+            callback.second();
+        }
+    }
+
+    busy.store(false, std::memory_order_release);
+    return true;
+}
+
+} // namespace mem
+} // namespace lwe
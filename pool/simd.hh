@@ -0,0 +1,116 @@
+#ifndef LWE_SIMD_HEADER
+#define LWE_SIMD_HEADER
+
+#include "config.hh"
+
+#include <type_traits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#    include <immintrin.h>
+#    define LWE_SIMD 1
+#endif
+
+#ifndef LWE_SIMD
+#    define LWE_SIMD 0
+#endif
+
+namespace lwe {
+namespace util {
+
+/*******************************************************************************
+ * search, count and reduction kernels over contiguous array
+ *
+ * ┌────────────────────────────┬───────┐
+ * │ lanes │ lanes │ ... │ lanes │ tail  │ << vector loop, scalar tail
+ * └────────────────────────────┴───────┘
+ *
+ * - vectorized: 4, 8 byte signed integer, float, double.
+ *   others are scalar, it needs only operators of T.
+ * - level: AVX2 when cpu supports, else SSE2 (x86-64 baseline), else scalar.
+ *   SSE2 has no 8 byte integer compare: scalar.
+ * - AVX2 kernels are compiled by target attribute, no compile option needed.
+ *
+ * @code {.cpp}
+ *  size_t at  = simd::find(arr, n, 100, simd::E_GT); // first over threshold, n: none
+ *  size_t cnt = simd::count(arr, n, 0, simd::E_LT);  // negative count
+ *  int    all = simd::sum(arr, n);
+ * @endcode
+ *
+ * NOTE: float sum is added in lane order, result can differ from scalar.
+ * NOTE: min / max with NaN is unspecified.
+ ******************************************************************************/
+struct simd {
+    simd() = delete;
+
+    /// @brief element (op) value
+    enum cmp : uint8_t {
+        E_EQ,
+        E_NE,
+        E_LT,
+        E_LE,
+        E_GT,
+        E_GE,
+    };
+
+    /// @brief instruction set
+    enum level : uint8_t {
+        E_SCALAR,
+        E_SSE2,
+        E_AVX2,
+    };
+
+    /// @brief supported level of cpu
+    static level detect() noexcept;
+
+    /// @brief using level, default is detect()
+    static level isa() noexcept;
+
+    /// @brief change using level, clamped to detect(): eg. for test
+    static void isa(level) noexcept;
+
+    /// @brief  first index of element (op) value
+    /// @return n: not found
+    template<typename T> static size_t find(const T*, size_t n, const T& value, cmp = E_EQ) noexcept;
+
+    /// @brief count of element (op) value
+    template<typename T> static size_t count(const T*, size_t n, const T& value, cmp = E_EQ) noexcept;
+
+    /// @brief sum of elements, T() when n is 0
+    template<typename T> static T sum(const T*, size_t n) noexcept;
+
+    /// @brief minimum element, n must be over 0
+    template<typename T> static T min(const T*, size_t n) noexcept;
+
+    /// @brief maximum element, n must be over 0
+    template<typename T> static T max(const T*, size_t n) noexcept;
+
+private:
+    /// @brief vectorized type of T, void is scalar
+    template<typename T> using lane = std::conditional_t<
+        std::is_same_v<T, float> || std::is_same_v<T, double>,
+        T,
+        std::conditional_t<std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == 4,
+                           int32_t,
+                           std::conditional_t<std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == 8,
+                                              int64_t,
+                                              void>>>;
+
+    /// @brief scalar compare
+    template<typename T> static bool test(const T&, const T&, cmp) noexcept;
+
+    /// @brief call fn(kernel) of using level to out
+    /// @return false: scalar
+    template<typename T, typename R, typename F> static bool dispatch(R* out, F&& fn) noexcept;
+
+    /// @brief array as element type of kernel
+    template<typename T, typename K> static auto cast(const T*, K) noexcept -> const typename K::L::type*;
+
+    /// @brief using level
+    static level& current() noexcept;
+};
+
+} // namespace util
+} // namespace lwe
+
+#include "simd.inl"
+#endif
@@ -0,0 +1,309 @@
+#include "simd.hh"
+
+namespace lwe {
+namespace util {
+
+#if LWE_SIMD
+//=============================================================================
+// SSE2
+//=============================================================================
+namespace sse2 {
+
+/// @brief lane traits, ENABLE is false: not vectorized
+template<typename T> struct lane {
+    static constexpr bool ENABLE = false;
+};
+
+template<> struct lane<int32_t> {
+    static constexpr bool ENABLE = true;
+    using type                   = int32_t;
+    using reg                    = __m128i;
+    enum : unsigned { LANES = 4, FULL = 0xF };
+
+    static reg load(const type* in) { return _mm_loadu_si128(reinterpret_cast<const reg*>(in)); }
+    static void store(type* out, reg in) { _mm_storeu_si128(reinterpret_cast<reg*>(out), in); }
+    static reg set(type in) { return _mm_set1_epi32(in); }
+    static reg zero() { return _mm_setzero_si128(); }
+    static reg add(reg a, reg b) { return _mm_add_epi32(a, b); }
+    static reg pick(reg m, reg a, reg b) { return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+    static reg min(reg a, reg b) { return pick(_mm_cmplt_epi32(a, b), a, b); }
+    static reg max(reg a, reg b) { return pick(_mm_cmpgt_epi32(a, b), a, b); }
+    static unsigned bits(reg in) { return _mm_movemask_ps(_mm_castsi128_ps(in)); }
+    static unsigned eq(reg a, reg b) { return bits(_mm_cmpeq_epi32(a, b)); }
+    static unsigned lt(reg a, reg b) { return bits(_mm_cmplt_epi32(a, b)); }
+    static unsigned le(reg a, reg b) { return bits(_mm_cmpgt_epi32(a, b)) ^ FULL; }
+};
+
+template<> struct lane<float> {
+    static constexpr bool ENABLE = true;
+    using type                   = float;
+    using reg                    = __m128;
+    enum : unsigned { LANES = 4, FULL = 0xF };
+
+    static reg load(const type* in) { return _mm_loadu_ps(in); }
+    static void store(type* out, reg in) { _mm_storeu_ps(out, in); }
+    static reg set(type in) { return _mm_set1_ps(in); }
+    static reg zero() { return _mm_setzero_ps(); }
+    static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+    static reg min(reg a, reg b) { return _mm_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm_max_ps(a, b); }
+    static unsigned eq(reg a, reg b) { return _mm_movemask_ps(_mm_cmpeq_ps(a, b)); }
+    static unsigned lt(reg a, reg b) { return _mm_movemask_ps(_mm_cmplt_ps(a, b)); }
+    static unsigned le(reg a, reg b) { return _mm_movemask_ps(_mm_cmple_ps(a, b)); }
+};
+
+template<> struct lane<double> {
+    static constexpr bool ENABLE = true;
+    using type                   = double;
+    using reg                    = __m128d;
+    enum : unsigned { LANES = 2, FULL = 0x3 };
+
+    static reg load(const type* in) { return _mm_loadu_pd(in); }
+    static void store(type* out, reg in) { _mm_storeu_pd(out, in); }
+    static reg set(type in) { return _mm_set1_pd(in); }
+    static reg zero() { return _mm_setzero_pd(); }
+    static reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+    static reg min(reg a, reg b) { return _mm_min_pd(a, b); }
+    static reg max(reg a, reg b) { return _mm_max_pd(a, b); }
+    static unsigned eq(reg a, reg b) { return _mm_movemask_pd(_mm_cmpeq_pd(a, b)); }
+    static unsigned lt(reg a, reg b) { return _mm_movemask_pd(_mm_cmplt_pd(a, b)); }
+    static unsigned le(reg a, reg b) { return _mm_movemask_pd(_mm_cmple_pd(a, b)); }
+};
+
+#    include "simd_kernel.inl"
+
+} // namespace sse2
+
+//=============================================================================
+// AVX2
+//=============================================================================
+#    if defined(__clang__)
+#        pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#    else
+#        pragma GCC push_options
+#        pragma GCC target("avx2")
+#    endif
+
+namespace avx2 {
+
+/// @brief lane traits, ENABLE is false: not vectorized
+template<typename T> struct lane {
+    static constexpr bool ENABLE = false;
+};
+
+template<> struct lane<int32_t> {
+    static constexpr bool ENABLE = true;
+    using type                   = int32_t;
+    using reg                    = __m256i;
+    enum : unsigned { LANES = 8, FULL = 0xFF };
+
+    static reg load(const type* in) { return _mm256_loadu_si256(reinterpret_cast<const reg*>(in)); }
+    static void store(type* out, reg in) { _mm256_storeu_si256(reinterpret_cast<reg*>(out), in); }
+    static reg set(type in) { return _mm256_set1_epi32(in); }
+    static reg zero() { return _mm256_setzero_si256(); }
+    static reg add(reg a, reg b) { return _mm256_add_epi32(a, b); }
+    static reg min(reg a, reg b) { return _mm256_min_epi32(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_epi32(a, b); }
+    static unsigned bits(reg in) { return _mm256_movemask_ps(_mm256_castsi256_ps(in)); }
+    static unsigned eq(reg a, reg b) { return bits(_mm256_cmpeq_epi32(a, b)); }
+    static unsigned lt(reg a, reg b) { return bits(_mm256_cmpgt_epi32(b, a)); }
+    static unsigned le(reg a, reg b) { return bits(_mm256_cmpgt_epi32(a, b)) ^ FULL; }
+};
+
+template<> struct lane<int64_t> {
+    static constexpr bool ENABLE = true;
+    using type                   = int64_t;
+    using reg                    = __m256i;
+    enum : unsigned { LANES = 4, FULL = 0xF };
+
+    static reg load(const type* in) { return _mm256_loadu_si256(reinterpret_cast<const reg*>(in)); }
+    static void store(type* out, reg in) { _mm256_storeu_si256(reinterpret_cast<reg*>(out), in); }
+    static reg set(type in) { return _mm256_set1_epi64x(in); }
+    static reg zero() { return _mm256_setzero_si256(); }
+    static reg add(reg a, reg b) { return _mm256_add_epi64(a, b); }
+    static reg min(reg a, reg b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(b, a)); }
+    static reg max(reg a, reg b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+    static unsigned bits(reg in) { return _mm256_movemask_pd(_mm256_castsi256_pd(in)); }
+    static unsigned eq(reg a, reg b) { return bits(_mm256_cmpeq_epi64(a, b)); }
+    static unsigned lt(reg a, reg b) { return bits(_mm256_cmpgt_epi64(b, a)); }
+    static unsigned le(reg a, reg b) { return bits(_mm256_cmpgt_epi64(a, b)) ^ FULL; }
+};
+
+template<> struct lane<float> {
+    static constexpr bool ENABLE = true;
+    using type                   = float;
+    using reg                    = __m256;
+    enum : unsigned { LANES = 8, FULL = 0xFF };
+
+    static reg load(const type* in) { return _mm256_loadu_ps(in); }
+    static void store(type* out, reg in) { _mm256_storeu_ps(out, in); }
+    static reg set(type in) { return _mm256_set1_ps(in); }
+    static reg zero() { return _mm256_setzero_ps(); }
+    static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+    static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+    static unsigned eq(reg a, reg b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+    static unsigned lt(reg a, reg b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+    static unsigned le(reg a, reg b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LE_OQ)); }
+};
+
+template<> struct lane<double> {
+    static constexpr bool ENABLE = true;
+    using type                   = double;
+    using reg                    = __m256d;
+    enum : unsigned { LANES = 4, FULL = 0xF };
+
+    static reg load(const type* in) { return _mm256_loadu_pd(in); }
+    static void store(type* out, reg in) { _mm256_storeu_pd(out, in); }
+    static reg set(type in) { return _mm256_set1_pd(in); }
+    static reg zero() { return _mm256_setzero_pd(); }
+    static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+    static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+    static unsigned eq(reg a, reg b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+    static unsigned lt(reg a, reg b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ)); }
+    static unsigned le(reg a, reg b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LE_OQ)); }
+};
+
+#    include "simd_kernel.inl"
+
+} // namespace avx2
+
+#    if defined(__clang__)
+#        pragma clang attribute pop
+#    else
+#        pragma GCC pop_options
+#    endif
+#endif
+
+template<typename T, typename R, typename F> bool simd::dispatch(R* out, F&& fn) noexcept {
+#if LWE_SIMD
+    using key = lane<T>;
+    if constexpr(!std::is_void_v<key>) {
+        level using_isa = isa();
+        if constexpr(avx2::lane<key>::ENABLE) {
+            if(using_isa == E_AVX2) {
+                *out = R(fn(avx2::kernel<key>{}));
+                return true;
+            }
+        }
+        if constexpr(sse2::lane<key>::ENABLE) {
+            if(using_isa >= E_SSE2) {
+                *out = R(fn(sse2::kernel<key>{}));
+                return true;
+            }
+        }
+    }
+#endif
+    return false;
+}
+
+template<typename T> size_t simd::find(const T* in, size_t n, const T& value, cmp op) noexcept {
+    size_t out;
+    if(dispatch<T>(&out, [&](auto k) { return k.find(cast(in, k), n, value, op); })) {
+        return out;
+    }
+
+    for(size_t i = 0; i < n; ++i) {
+        if(test(in[i], value, op)) {
+            return i;
+        }
+    }
+    return n;
+}
+
+template<typename T> size_t simd::count(const T* in, size_t n, const T& value, cmp op) noexcept {
+    size_t out = 0;
+    if(dispatch<T>(&out, [&](auto k) { return k.count(cast(in, k), n, value, op); })) {
+        return out;
+    }
+
+    for(size_t i = 0; i < n; ++i) {
+        out += test(in[i], value, op);
+    }
+    return out;
+}
+
+template<typename T> T simd::sum(const T* in, size_t n) noexcept {
+    T out = T();
+    if(dispatch<T>(&out, [&](auto k) { return k.sum(cast(in, k), n); })) {
+        return out;
+    }
+
+    for(size_t i = 0; i < n; ++i) {
+        out += in[i];
+    }
+    return out;
+}
+
+template<typename T> T simd::min(const T* in, size_t n) noexcept {
+    T out = in[0];
+    if(dispatch<T>(&out, [&](auto k) { return k.template extreme<false>(cast(in, k), n); })) {
+        return out;
+    }
+
+    for(size_t i = 1; i < n; ++i) {
+        if(in[i] < out) {
+            out = in[i];
+        }
+    }
+    return out;
+}
+
+template<typename T> T simd::max(const T* in, size_t n) noexcept {
+    T out = in[0];
+    if(dispatch<T>(&out, [&](auto k) { return k.template extreme<true>(cast(in, k), n); })) {
+        return out;
+    }
+
+    for(size_t i = 1; i < n; ++i) {
+        if(out < in[i]) {
+            out = in[i];
+        }
+    }
+    return out;
+}
+
+template<typename T, typename K> auto simd::cast(const T* in, K) noexcept -> const typename K::L::type* {
+    return reinterpret_cast<const typename K::L::type*>(in);
+}
+
+template<typename T> bool simd::test(const T& a, const T& b, cmp op) noexcept {
+    switch(op) {
+    case E_EQ: return a == b;
+    case E_NE: return a != b;
+    case E_LT: return a < b;
+    case E_LE: return a <= b;
+    case E_GT: return b < a;
+    default:   return b <= a;
+    }
+}
+
+simd::level simd::detect() noexcept {
+#if LWE_SIMD
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) {
+        return E_AVX2;
+    }
+    return E_SSE2;
+#else
+    return E_SCALAR;
+#endif
+}
+
+simd::level simd::isa() noexcept {
+    return current();
+}
+
+void simd::isa(level in) noexcept {
+    level top = detect();
+    current() = in < top ? in : top;
+}
+
+simd::level& simd::current() noexcept {
+    static level instance = detect();
+    return instance;
+}
+
+} // namespace util
+} // namespace lwe
@@ -0,0 +1,114 @@
+// NOTE: NO INCLUDE GUARD, included once per instruction set by simd.inl
+//       namespace of includer has 'lane<T>' traits.
+
+/// @brief kernels of lane<T>
+template<typename T> struct kernel {
+    using L   = lane<T>;
+    using reg = typename L::reg;
+
+    /// @brief compare mask, bit per lane
+    static unsigned mask(reg a, reg b, simd::cmp op) noexcept {
+        switch(op) {
+        case simd::E_EQ: return L::eq(a, b);
+        case simd::E_NE: return L::eq(a, b) ^ L::FULL;
+        case simd::E_LT: return L::lt(a, b);
+        case simd::E_LE: return L::le(a, b);
+        case simd::E_GT: return L::lt(b, a);
+        default:         return L::le(b, a);
+        }
+    }
+
+    /// @brief scalar compare for tail
+    static bool test(T a, T b, simd::cmp op) noexcept {
+        switch(op) {
+        case simd::E_EQ: return a == b;
+        case simd::E_NE: return a != b;
+        case simd::E_LT: return a < b;
+        case simd::E_LE: return a <= b;
+        case simd::E_GT: return b < a;
+        default:         return b <= a;
+        }
+    }
+
+    static size_t find(const T* in, size_t n, T value, simd::cmp op) noexcept {
+        reg key = L::set(value);
+
+        size_t i = 0;
+        for(; i + L::LANES <= n; i += L::LANES) {
+            unsigned bits = mask(L::load(in + i), key, op);
+            if(bits) {
+                return i + __builtin_ctz(bits);
+            }
+        }
+        for(; i < n; ++i) {
+            if(test(in[i], value, op)) {
+                return i;
+            }
+        }
+        return n;
+    }
+
+    static size_t count(const T* in, size_t n, T value, simd::cmp op) noexcept {
+        reg key = L::set(value);
+
+        size_t out = 0;
+        size_t i   = 0;
+        for(; i + L::LANES <= n; i += L::LANES) {
+            out += __builtin_popcount(mask(L::load(in + i), key, op));
+        }
+        for(; i < n; ++i) {
+            out += test(in[i], value, op);
+        }
+        return out;
+    }
+
+    static T sum(const T* in, size_t n) noexcept {
+        reg acc = L::zero();
+
+        size_t i = 0;
+        for(; i + L::LANES <= n; i += L::LANES) {
+            acc = L::add(acc, L::load(in + i));
+        }
+
+        T lanes[L::LANES];
+        L::store(lanes, acc);
+
+        T out = lanes[0];
+        for(size_t j = 1; j < L::LANES; ++j) {
+            out += lanes[j];
+        }
+        for(; i < n; ++i) {
+            out += in[i];
+        }
+        return out;
+    }
+
+    /// @brief min or max, n is over 0
+    template<bool Max> static T extreme(const T* in, size_t n) noexcept {
+        T out = in[0];
+
+        size_t i = 0;
+        if(n >= L::LANES) {
+            reg acc = L::load(in);
+            for(i = L::LANES; i + L::LANES <= n; i += L::LANES) {
+                acc = Max ? L::max(L::load(in + i), acc) : L::min(L::load(in + i), acc);
+            }
+
+            T lanes[L::LANES];
+            L::store(lanes, acc);
+
+            out = lanes[0];
+            for(size_t j = 1; j < L::LANES; ++j) {
+                if(Max ? out < lanes[j] : lanes[j] < out) {
+                    out = lanes[j];
+                }
+            }
+        }
+        for(; i < n; ++i) {
+            if(Max ? out < in[i] : in[i] < out) {
+                out = in[i];
+            }
+        }
+        return out;
+    }
+};
@@ -0,0 +1,89 @@
+#ifndef LWE_SLAB_HEADER
+#define LWE_SLAB_HEADER
+
+#include "pool.hh"
+
+namespace lwe {
+namespace mem {
+
+/*******************************************************************************
+ * constructed object cache (slab object caching, Bonwick 1994)
+ *
+ * pool chunk lifetime
+ *  ┌───────────┐ T() once ┌──────────┐ acquire ┌───────┐
+ *  │ raw chunk │ ───────> │  cached  │ ──────> │ using │
+ *  └───────────┘          └──────────┘ <────── └───────┘
+ *        ^                      │       release (reset hook)
+ *        └──────── ~T() ────────┘ purge
+ *
+ * - constructor / destructor cost is paid once per chunk, not per use.
+ * - reset hook: return object to initial state, eg. clear(), keep capacity.
+ *
+ * how to use
+ *
+ * @code {.cpp}
+ *  slab<type>& cache = slab<type>::statics();
+ *  type* obj = cache.acquire(); // constructed
+ *  cache.release(obj);          // kept constructed
+ *  cache.purge();               // actual destruct
+ * @endcode
+ *
+ * NOTE: NOT THREAD-SAFE, statics() is thread_local.
+ * NOTE: release to the cache that acquired it.
+ ******************************************************************************/
+template<typename T, size_t Align = alignof(T), size_t Count = config::DEF_CACHE> class slab {
+public:
+    slab(const slab&)            = delete;
+    slab& operator=(const slab&) = delete;
+    slab(slab&&)                 = delete;
+    slab& operator=(slab&&)      = delete;
+
+public:
+    /// @brief called on release, before cached
+    using reset = void (*)(T*);
+
+public:
+    /// @brief thread local cache
+    static slab& statics();
+
+public:
+    /// @param [in] hook - reset hook, nullptr: not called
+    slab(reset hook = nullptr) noexcept;
+
+public:
+    /// @brief destruct cached objects
+    ~slab() noexcept;
+
+public:
+    /// @brief get constructed object, construct when no cached
+    /// @param [in] args - constructor arguments, used only when constructed
+    template<typename... Args> T* acquire(Args&&...) noexcept;
+
+public:
+    /// @brief call reset hook and keep constructed
+    void release(T*) noexcept;
+
+public:
+    /// @brief destruct all cached objects and return chunks, then pool cleanup
+    void purge() noexcept;
+
+public:
+    /// @brief cached object count
+    size_t size() const noexcept;
+
+private:
+    const reset HOOK;
+
+private:
+    /// @brief constructed, unused
+    data::deque<T*> cached;
+
+private:
+    pool chunks;
+};
+
+} // namespace mem
+} // namespace lwe
+
+#include "slab.inl"
+#endif
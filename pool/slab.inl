@@ -0,0 +1,65 @@
+#include "slab.hh"
+
+namespace lwe {
+namespace mem {
+
+template<typename T, size_t Align, size_t Count> auto slab<T, Align, Count>::statics() -> slab& {
+    static thread_local slab instance;
+    return instance;
+}
+
+// clang-format off
+template<typename T, size_t Align, size_t Count> slab<T, Align, Count>::slab(reset hook) noexcept :
+    HOOK{ hook },
+    chunks(sizeof(T), Align, Count)
+{}
+// clang-format on
+
+template<typename T, size_t Align, size_t Count> slab<T, Align, Count>::~slab() noexcept {
+    purge();
+}
+
+template<typename T, size_t Align, size_t Count>
+template<typename... Args>
+T* slab<T, Align, Count>::acquire(Args&&... args) noexcept {
+    T* out = nullptr;
+    if(cached.lifo(&out)) {
+        return out; // warm: last released
+    }
+
+    void* ptr = chunks.construct();
+    if(!ptr) {
+        return nullptr;
+    }
+    return new(ptr) T(std::forward<Args>(args)...);
+}
+
+template<typename T, size_t Align, size_t Count> void slab<T, Align, Count>::release(T* in) noexcept {
+    if(!in) return;
+
+    if(HOOK) {
+        HOOK(in);
+    }
+
+    // failed to cache: actual destruct
+    if(!cached.push(in)) {
+        in->~T();
+        chunks.destruct(static_cast<void*>(in));
+    }
+}
+
+template<typename T, size_t Align, size_t Count> void slab<T, Align, Count>::purge() noexcept {
+    T* out = nullptr;
+    while(cached.lifo(&out)) {
+        out->~T();
+        chunks.destruct(static_cast<void*>(out));
+    }
+    chunks.cleanup();
+}
+
+template<typename T, size_t Align, size_t Count> size_t slab<T, Align, Count>::size() const noexcept {
+    return cached.size();
+}
+
+} // namespace mem
+} // namespace lwe
@@ -0,0 +1,165 @@
+#ifndef LWE_SNAPSHOT_HEADER
+#define LWE_SNAPSHOT_HEADER
+
+#include "config.hh"
+#include "aligner.hh"
+
+#ifndef _WIN32
+//=============================================================================
+// POSIX
+//=============================================================================
+#    include <fcntl.h>
+#    include <unistd.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+
+/*******************************************************************************
+ * snapshot structure
+ *
+ * file is mapped once with 'reserve' length, grows by block with ftruncate.
+ * mapping address is not moved while opened, so returned pointers are stable.
+ * every internal link is offset from file begin, so it can be mapped anywhere.
+ *
+ * 0                   HEADER              HEADER + TOTAL          | << offset
+ * ^                   ^                   ^                       |
+ * ├────────┬──────────┼───────┬───────┬───┼───────┬───────┬───┬   |
+ * │ header │ padding  │ chunk │ chunk │...│ chunk │ chunk │...│   |
+ * └────────┴──────────┼───────┴───────┴───┼───────┴───────┴───┴   |
+ *                     └ ─ ─  block  ─ ─ ─ ┘                       |
+ *
+ * - header: layout and state, page aligned
+ *   ├─[8 byte]: magic
+ *   ├─[8 byte]: chunk size (check)
+ *   ├─[8 byte]: chunk align (check)
+ *   ├─[8 byte]: chunk count in block (check)
+ *   ├─[8 byte]: used size (end of last block)
+ *   ├─[8 byte]: free list offset
+ *   ├─[8 byte]: using chunk count
+ *   └─[8 byte]: root object offset
+ *
+ * - chunk: no meta, single file is single parent.
+ *   └─ free: first 8 byte is next free chunk offset (0 is null)
+ *
+ * NOTE: offset 0 is header, so never a chunk: used as null.
+ ******************************************************************************/
+
+namespace lwe {
+namespace mem {
+
+/*******************************************************************************
+ * NOTE: NOT THREAD-SAFE, POSIX ONLY
+ *******************************************************************************
+ * how to use
+ *
+ * @code {.cpp}
+ *  snapshot file("graph.bin", sizeof(node));      // open or create
+ *  node* root = file.root<node>();                // nullptr when new file
+ *  if(!root) {
+ *      root = file.construct<node>(...);
+ *      file.root(root);                           // save entry point
+ *  }
+ *  root->child = file.offset(file.construct<node>(...)); // link by offset
+ *  node* child = file.pointer<node>(root->child);        // follow link
+ *  file.flush();                                         // optional: msync
+ * @endcode
+ *
+ * - objects in file must not hold raw pointers: use offset() / pointer().
+ * - T must be trivially copyable to be meaningful after reopen.
+ * - reopen with different chunk / align / count is fail: valid() is false.
+ ******************************************************************************/
+class snapshot {
+public:
+    snapshot(const snapshot&)            = delete;
+    snapshot& operator=(const snapshot&) = delete;
+    snapshot(snapshot&&)                 = delete;
+    snapshot& operator=(snapshot&&)      = delete;
+
+private:
+    /// @brief file header, first page of file
+    struct header;
+
+public:
+    /**
+     * @brief open or create file backed pool
+     *
+     * @param [in] path    - file path, created when not exist.
+     * @param [in] chunk   - chunk size, at least free link (8 byte), it is padded to the align.
+     * @param [in] align   - chunk align, it is adjusted to the power of 2.
+     * @param [in] count   - chunk count in block, at least 1, it is padded to the cache.
+     * @param [in] reserve - max file size, virtual address only.
+     */
+    snapshot(const char* path,
+             size_t      chunk,
+             size_t      align   = config::DEF_ALIGN,
+             size_t      count   = config::DEF_CACHE,
+             size_t      reserve = config::DEF_RESERVE) noexcept;
+
+public:
+    /// @brief flush and unmap, file is kept.
+    ~snapshot() noexcept;
+
+public:
+    /// @brief get memory in file, grow file when free list is empty.
+    template<typename T = void, typename... Args> T* construct(Args&&...) noexcept;
+
+public:
+    /// @brief return memory to free list.
+    /// @note  pointer that is not a chunk of this file is ignored.
+    template<typename T = void> void destruct(T*) noexcept;
+
+public:
+    /// @brief write back dirty pages: msync
+    bool flush() noexcept;
+
+public:
+    /// @brief file is opened and layout is matched
+    bool valid() const noexcept;
+
+public:
+    /// @brief pointer to offset, nullptr is 0
+    size_t offset(const void*) const noexcept;
+
+public:
+    /// @brief offset to pointer, 0 is nullptr
+    template<typename T = void> T* pointer(size_t) const noexcept;
+
+public:
+    /// @brief get saved entry object
+    template<typename T = void> T* root() const noexcept;
+
+public:
+    /// @brief save entry object, it is restored on reopen
+    void root(const void*) noexcept;
+
+public:
+    /// @brief using chunk count
+    size_t size() const noexcept;
+
+private:
+    /// @brief append block to file
+    bool setup() noexcept;
+
+private:
+    /// @brief chunk start in used range of file
+    bool inside(const void*) const noexcept;
+
+private:
+    const size_t ALIGN;
+    const size_t HEADER;
+    const size_t CHUNK;
+    const size_t COUNT;
+    const size_t TOTAL;
+    const size_t RESERVE;
+
+private:
+    int      fd   = -1;
+    uint8_t* base = nullptr;
+    header*  head = nullptr;
+};
+
+} // namespace mem
+} // namespace lwe
+
+#    include "snapshot.inl"
+#endif
+#endif
@@ -0,0 +1,206 @@
+#include "snapshot.hh"
+
+namespace lwe {
+namespace mem {
+
+struct snapshot::header {
+    static constexpr uint64_t MAGIC = 0x4C57452D534E4150; // "LWE-SNAP"
+
+    uint64_t magic;
+    uint64_t chunk;
+    uint64_t align;
+    uint64_t count;
+    uint64_t size;
+    uint64_t free;
+    uint64_t used;
+    uint64_t root;
+};
+
+// clang-format off
+snapshot::snapshot(const char* path, size_t chunk, size_t align, size_t count, size_t reserve) noexcept :
+    ALIGN{   util::aligner::boundary(align) },
+    HEADER{  util::aligner::padding(sizeof(header), ALIGN > 4096 ? ALIGN : 4096) },
+    CHUNK{   util::aligner::padding(chunk < sizeof(uint64_t) ? sizeof(uint64_t) : chunk, ALIGN) },
+    COUNT{   util::aligner::padding(count ? count : 1, config::DEF_CACHE) },
+    TOTAL{   CHUNK * COUNT },
+    RESERVE{ util::aligner::padding(reserve, HEADER) }
+{
+    fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    if(fd < 0) {
+        return;
+    }
+
+    struct stat info;
+    if(::fstat(fd, &info) != 0) {
+        ::close(fd);
+        fd = -1;
+        return;
+    }
+
+    // new file: header only
+    bool create = info.st_size == 0;
+    if(create && ::ftruncate(fd, HEADER) != 0) {
+        ::close(fd);
+        fd = -1;
+        return;
+    }
+
+    void* map = ::mmap(nullptr, RESERVE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if(map == MAP_FAILED) {
+        ::close(fd);
+        fd = -1;
+        return;
+    }
+    base = static_cast<uint8_t*>(map);
+    head = reinterpret_cast<header*>(base);
+
+    if(create) {
+        head->magic  = header::MAGIC;
+        head->chunk  = CHUNK;
+        head->align  = ALIGN;
+        head->count  = COUNT;
+        head->size   = HEADER;
+        head->free   = 0;
+        head->used   = 0;
+        head->root   = 0;
+        return;
+    }
+
+    // check layout
+    if(size_t(info.st_size) < HEADER ||
+       head->magic != header::MAGIC ||
+       head->chunk != CHUNK ||
+       head->align != ALIGN ||
+       head->count != COUNT ||
+       head->size > size_t(info.st_size) ||
+       head->size > RESERVE) {
+        ::munmap(base, RESERVE);
+        ::close(fd);
+        fd   = -1;
+        base = nullptr;
+        head = nullptr;
+    }
+}
+// clang-format on
+
+snapshot::~snapshot() noexcept {
+    if(base) {
+        flush();
+        ::munmap(base, RESERVE);
+    }
+    if(fd >= 0) {
+        ::close(fd);
+    }
+}
+
+bool snapshot::setup() noexcept {
+    size_t from = head->size;
+    size_t to   = from + TOTAL;
+    if(to > RESERVE || ::ftruncate(fd, to) != 0) {
+        return false;
+    }
+
+    // link chunks by offset, last one is linked to current free list
+    for(size_t i = from; i < to - CHUNK; i += CHUNK) {
+        *reinterpret_cast<uint64_t*>(base + i) = i + CHUNK;
+    }
+    *reinterpret_cast<uint64_t*>(base + to - CHUNK) = head->free;
+
+    head->free = from;
+    head->size = to;
+    return true;
+}
+
+template<typename T, typename... Args> inline T* snapshot::construct(Args&&... args) noexcept {
+    if(!base) {
+        return nullptr;
+    }
+
+    if(head->free == 0 && !setup()) {
+        return nullptr;
+    }
+
+    uint8_t* ptr = base + head->free;
+    head->free   = *reinterpret_cast<uint64_t*>(ptr);
+    ++head->used;
+
+    T* ret = reinterpret_cast<T*>(ptr);
+    if constexpr(!std::is_pointer_v<T> && !std::is_same_v<T, void>) {
+        new(ret) T({ std::forward<Args>(args)... }); // new
+    }
+    return ret;
+}
+
+template<typename T> void snapshot::destruct(T* in) noexcept {
+    if(!in || !inside(in)) return;
+
+    // delete
+    if constexpr(!std::is_pointer_v<T> && !std::is_void_v<T>) {
+        in->~T();
+    }
+
+    *reinterpret_cast<uint64_t*>(in) = head->free;
+    head->free                       = offset(in);
+    --head->used;
+}
+
+bool snapshot::inside(const void* in) const noexcept {
+    if(!base) {
+        return false;
+    }
+
+    // blocks are appended from header: chunk is at HEADER + CHUNK * n
+    const uint8_t* ptr = static_cast<const uint8_t*>(in);
+    if(ptr < base + HEADER || ptr >= base + head->size) {
+        return false;
+    }
+    return (size_t(ptr - base) - HEADER) % CHUNK == 0;
+}
+
+bool snapshot::flush() noexcept {
+    if(!base) {
+        return false;
+    }
+    return ::msync(base, head->size, MS_SYNC) == 0;
+}
+
+bool snapshot::valid() const noexcept {
+    return base != nullptr;
+}
+
+size_t snapshot::offset(const void* in) const noexcept {
+    if(!in) {
+        return 0;
+    }
+    return static_cast<const uint8_t*>(in) - base;
+}
+
+template<typename T> T* snapshot::pointer(size_t in) const noexcept {
+    if(in == 0 || !base) {
+        return nullptr;
+    }
+    return reinterpret_cast<T*>(base + in);
+}
+
+template<typename T> T* snapshot::root() const noexcept {
+    if(!base) {
+        return nullptr;
+    }
+    return pointer<T>(head->root);
+}
+
+void snapshot::root(const void* in) noexcept {
+    if(base) {
+        head->root = offset(in);
+    }
+}
+
+size_t snapshot::size() const noexcept {
+    if(!base) {
+        return 0;
+    }
+    return head->used;
+}
+
+} // namespace mem
+} // namespace lwe
@@ -0,0 +1,82 @@
+#ifndef LWE_SPSC_HEADER
+#define LWE_SPSC_HEADER
+
+#include "allocator.hh"
+
+namespace lwe {
+namespace data {
+
+/*******************************************************************************
+ * lock-free single producer / single consumer unbounded queue
+ *
+ * node: same layout as deque node, fixed array with next pointer.
+ *
+ *  first ─> node ─> node ─> node ─> node <─ last   | << producer
+ *  └ recycle ─┘     ^ done                         | << consumer: current node
+ *
+ * - producer publishes count of node by 'tail' (release).
+ * - consumer publishes its current node by 'done' (release).
+ * - nodes before 'done' are consumed: producer reuses them,
+ *   allocator is called only when whole chain is in use.
+ * - first node is allocated by constructor, on failure by first push.
+ *
+ * NOTE: push / emplace only one thread, pop only one thread.
+ ******************************************************************************/
+template<typename T, size_t Size = config::DEF_CACHE, size_t Align = config::DEF_ALIGN> class spsc_queue {
+    struct node;
+
+public:
+    spsc_queue();
+    ~spsc_queue();
+
+public:
+    spsc_queue(const spsc_queue&)            = delete;
+    spsc_queue(spsc_queue&&)                 = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+    spsc_queue& operator=(spsc_queue&&)      = delete;
+
+public:
+    /// @brief producer: push back
+    /// @return false: failed to allocate
+    template<typename Arg> bool push(Arg&&);
+
+public:
+    /// @brief producer: construct in place
+    /// @return false: failed to allocate
+    template<typename... Args> bool emplace(Args&&...);
+
+public:
+    /// @brief consumer: pop front, moved to out then destructor
+    /// @return false: at empty
+    bool pop(T*);
+
+public:
+    /// @brief consumer: nothing to pop
+    bool empty() const;
+
+private:
+    /// @brief producer: reuse consumed node, else allocate
+    node* create();
+
+private:
+    /// @brief producer side
+    alignas(64) node* last;
+    node*             first;
+    node*             cache; // last read 'done'
+    size_t            write;
+
+private:
+    /// @brief consumer side
+    alignas(64) node* current;
+    size_t            read;
+
+private:
+    /// @brief shared: current node of consumer
+    alignas(64) std::atomic<node*> done;
+};
+
+} // namespace data
+} // namespace lwe
+
+#include "spsc.inl"
+#endif
@@ -0,0 +1,173 @@
+#include "spsc.hh"
+
+namespace lwe {
+namespace data {
+
+template<typename T, size_t Size, size_t Align> struct spsc_queue<T, Size, Align>::node {
+    /// @brief union for ignore calls to constructor and destructor
+    union {
+        T       array[Size];
+        uint8_t serialized[sizeof(T) * Size];
+    };
+
+    std::atomic<node*>  next;
+    std::atomic<size_t> tail;
+};
+
+template<typename T, size_t Size, size_t Align> spsc_queue<T, Size, Align>::spsc_queue() {
+    // nothing consumed: allocate first node
+    first = nullptr;
+    cache = nullptr;
+    done.store(nullptr, std::memory_order_relaxed);
+    last = create();
+
+    first   = last;
+    cache   = last;
+    current = last;
+    write   = 0;
+    read    = 0;
+    done.store(last, std::memory_order_release);
+}
+
+template<typename T, size_t Size, size_t Align> spsc_queue<T, Size, Align>::~spsc_queue() {
+    // consumer has not seen first node yet
+    if(!current) {
+        current = done.load(std::memory_order_acquire);
+    }
+
+    // consumed nodes
+    while(first != current) {
+        node* temp = first;
+        first      = first->next.load(std::memory_order_relaxed);
+        mem::allocator::free(temp);
+    }
+
+    // remaining elements
+    size_t from = read;
+    while(first) {
+        size_t tail = first->tail.load(std::memory_order_relaxed);
+        for(size_t i = from; i < tail; ++i) {
+            first->array[i].~T();
+        }
+        from = 0;
+
+        node* temp = first;
+        first      = first->next.load(std::memory_order_relaxed);
+        mem::allocator::free(temp);
+    }
+}
+
+template<typename T, size_t Size, size_t Align> template<typename Arg> bool spsc_queue<T, Size, Align>::push(Arg&& in) {
+    return emplace(std::forward<Arg>(in));
+}
+
+template<typename T, size_t Size, size_t Align>
+template<typename... Args>
+bool spsc_queue<T, Size, Align>::emplace(Args&&... args) {
+    // first node failed in constructor: retry, publish to consumer by 'done'
+    if(!last) {
+        node* ptr = create();
+        if(!ptr) {
+            return false;
+        }
+        first = ptr;
+        cache = ptr;
+        last  = ptr;
+        done.store(ptr, std::memory_order_release);
+    }
+
+    if(write == Size) {
+        node* ptr = create();
+        if(!ptr) {
+            return false;
+        }
+        last->next.store(ptr, std::memory_order_release);
+        last  = ptr;
+        write = 0;
+    }
+
+    new(last->array + write) T(std::forward<Args>(args)...);
+    last->tail.store(++write, std::memory_order_release);
+    return true;
+}
+
+template<typename T, size_t Size, size_t Align> bool spsc_queue<T, Size, Align>::pop(T* out) {
+    if(!current) {
+        current = done.load(std::memory_order_acquire);
+        if(!current) {
+            return false;
+        }
+    }
+
+    size_t tail = current->tail.load(std::memory_order_acquire);
+    if(read == tail) {
+        if(tail < Size) {
+            return false;
+        }
+
+        // node is consumed: move to next, old one can be reused by producer
+        node* next = current->next.load(std::memory_order_acquire);
+        if(!next) {
+            return false;
+        }
+        current = next;
+        read    = 0;
+        done.store(next, std::memory_order_release);
+
+        if(current->tail.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+    }
+
+    T* in = current->array + read;
+    if(out) {
+        *out = std::move(*in);
+    }
+    in->~T();
+    ++read;
+    return true;
+}
+
+template<typename T, size_t Size, size_t Align> bool spsc_queue<T, Size, Align>::empty() const {
+    if(!current) {
+        node* ptr = done.load(std::memory_order_acquire);
+        return !ptr || ptr->tail.load(std::memory_order_acquire) == 0;
+    }
+
+    size_t tail = current->tail.load(std::memory_order_acquire);
+    if(read < tail) {
+        return false;
+    }
+    if(tail < Size) {
+        return true;
+    }
+    node* next = current->next.load(std::memory_order_acquire);
+    return !next || next->tail.load(std::memory_order_acquire) == 0;
+}
+
+template<typename T, size_t Size, size_t Align> auto spsc_queue<T, Size, Align>::create() -> node* {
+    node* ptr = nullptr;
+
+    // consumed node
+    if(first == cache) {
+        cache = done.load(std::memory_order_acquire);
+    }
+    if(first != cache) {
+        ptr   = first;
+        first = first->next.load(std::memory_order_relaxed);
+    } else {
+        ptr = static_cast<node*>(mem::allocator::malloc(sizeof(node), Align));
+        if(!ptr) {
+            return nullptr;
+        }
+        new(&ptr->next) std::atomic<node*>();
+        new(&ptr->tail) std::atomic<size_t>();
+    }
+
+    ptr->next.store(nullptr, std::memory_order_relaxed);
+    ptr->tail.store(0, std::memory_order_relaxed);
+    return ptr;
+}
+
+} // namespace data
+} // namespace lwe
@@ -0,0 +1,123 @@
+#ifndef LWE_THREAD_POOL_HEADER
+#define LWE_THREAD_POOL_HEADER
+
+#include "pool.hh"
+#include "chaselev.hh"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace lwe {
+namespace exec {
+
+/*******************************************************************************
+ * work-stealing thread pool
+ *
+ * ┌────────────┐  push / take  ┌──────────────────┐
+ * │ worker [n] │ ───────────── │ chaselev<task*>  │ << owner: bottom
+ * └────────────┘               └──────────────────┘
+ *       │            steal                ^
+ *       └─────────────────────────────────┘ << other workers: top
+ *
+ * - submit from worker: push to own deque.
+ * - submit from other thread: push to inject queue. (lock-free)
+ * - task object is get from pool::statics of submit thread,
+ *   and returned by the worker that ran it: pool::destruct to its own pool,
+ *   or to the gc of submit thread pool when different.
+ *
+ * how to use
+ *
+ * @code {.cpp}
+ *  exec::thread_pool workers(8);
+ *  workers.submit([&] { ... });
+ *  workers.wait();
+ * @endcode
+ *
+ * NOTE: STATICS IS RELEASE WHEN THREAD END
+ * submit thread can end before its tasks are done: blocks of its pool::statics
+ * are inherited until the workers return the last task.
+ * NOTE: task must not throw, wait() must not be called by worker.
+ ******************************************************************************/
+class thread_pool {
+public:
+    thread_pool(const thread_pool&)            = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+    thread_pool(thread_pool&&)                 = delete;
+    thread_pool& operator=(thread_pool&&)      = delete;
+
+private:
+    /// @brief type erased task header
+    struct task;
+
+private:
+    /// @brief task with callable
+    template<typename F> struct holder;
+
+private:
+    /// @brief worker thread and its deque
+    struct worker;
+
+public:
+    /// @param [in] count - worker count, 0 is hardware concurrency.
+    thread_pool(size_t count = 0);
+
+public:
+    /// @brief run remaining tasks and join
+    ~thread_pool();
+
+public:
+    /// @brief enqueue task
+    /// @return false: failed to allocate
+    template<typename F> bool submit(F&&) noexcept;
+
+public:
+    /// @brief block until all submitted tasks are done
+    void wait() noexcept;
+
+public:
+    /// @brief worker count
+    size_t size() const noexcept;
+
+private:
+    /// @brief worker main
+    void run(size_t) noexcept;
+
+private:
+    /// @brief own -> inject -> steal
+    bool next(size_t, task**) noexcept;
+
+private:
+    /// @brief stopped and all tasks are done
+    bool finished() const noexcept;
+
+private:
+    /// @brief pool and worker index of current thread
+    static thread_local thread_pool* owner;
+    static thread_local size_t       index;
+
+private:
+    worker* workers = nullptr;
+    size_t  count   = 0;
+
+private:
+    /// @brief tasks from non-worker thread
+    data::mpmc_queue<task*> inject;
+
+private:
+    std::atomic<int64_t> queued;  // in deques, counted after push
+    std::atomic<size_t>  pending; // queued + running
+    std::atomic<size_t>  sleeping;
+    std::atomic<bool>    stop;
+
+private:
+    std::mutex              lock;
+    std::condition_variable signal;
+    std::condition_variable done;
+};
+
+} // namespace exec
+} // namespace lwe
+
+#include "thread_pool.inl"
+#endif
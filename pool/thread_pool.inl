@@ -0,0 +1,163 @@
+#include "thread_pool.hh"
+
+namespace lwe {
+namespace exec {
+
+struct thread_pool::task {
+    void (*call)(task*) noexcept;
+};
+
+template<typename F> struct thread_pool::holder: task {
+    holder(F&& in): task{ &invoke }, fn(std::move(in)) {}
+    holder(const F& in): task{ &invoke }, fn(in) {}
+
+    /// @brief run and return memory to running thread pool
+    static void invoke(task* self) noexcept {
+        holder* ptr = static_cast<holder*>(self);
+        ptr->fn();
+        ptr->~holder();
+        mem::pool::statics<sizeof(holder), alignof(holder)>().destruct(static_cast<void*>(ptr));
+    }
+
+    F fn;
+};
+
+struct thread_pool::worker {
+    data::chaselev<task*> queue;
+    std::thread           thread;
+};
+
+thread_local thread_pool* thread_pool::owner = nullptr;
+thread_local size_t       thread_pool::index = 0;
+
+thread_pool::thread_pool(size_t in) {
+    queued.store(0, std::memory_order_relaxed);
+    pending.store(0, std::memory_order_relaxed);
+    sleeping.store(0, std::memory_order_relaxed);
+    stop.store(false, std::memory_order_relaxed);
+
+    if(in == 0) {
+        in = std::thread::hardware_concurrency();
+        if(in == 0) {
+            in = 1;
+        }
+    }
+
+    count   = in;
+    workers = new worker[count];
+    for(size_t i = 0; i < count; ++i) {
+        workers[i].thread = std::thread([this, i] { run(i); });
+    }
+}
+
+thread_pool::~thread_pool() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stop.store(true, std::memory_order_relaxed);
+    }
+    signal.notify_all();
+
+    for(size_t i = 0; i < count; ++i) {
+        workers[i].thread.join();
+    }
+    delete[] workers;
+}
+
+template<typename F> bool thread_pool::submit(F&& fn) noexcept {
+    using type = holder<std::decay_t<F>>;
+
+    void* ptr = mem::pool::statics<sizeof(type), alignof(type)>().construct();
+    if(!ptr) {
+        return false;
+    }
+    task* job = new(ptr) type(std::forward<F>(fn));
+
+    pending.fetch_add(1, std::memory_order_relaxed);
+
+    // worker: own deque, fallback to inject when failed to grow
+    if(owner != this || !workers[index].queue.push(job)) {
+        if(!inject.push(job)) {
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            static_cast<type*>(job)->~type();
+            mem::pool::statics<sizeof(type), alignof(type)>().destruct(ptr);
+            return false;
+        }
+    }
+
+    // after push: can be taken before this, count is -1 for a moment
+    // seq_cst with worker: sees sleeping, or worker sees queued
+    queued.fetch_add(1, std::memory_order_seq_cst);
+
+    // wake one, lock for not missing signal
+    if(sleeping.load(std::memory_order_seq_cst)) {
+        { std::lock_guard<std::mutex> guard(lock); }
+        signal.notify_one();
+    }
+    return true;
+}
+
+void thread_pool::wait() noexcept {
+    std::unique_lock<std::mutex> guard(lock);
+    done.wait(guard, [this] { return pending.load(std::memory_order_acquire) == 0; });
+}
+
+size_t thread_pool::size() const noexcept {
+    return count;
+}
+
+void thread_pool::run(size_t self) noexcept {
+    owner = this;
+    index = self;
+
+    while(true) {
+        task* job = nullptr;
+        if(next(self, &job)) {
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            job->call(job);
+
+            // last one: wake waiters, and sleeping workers when stopping
+            if(pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                { std::lock_guard<std::mutex> guard(lock); }
+                done.notify_all();
+                signal.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(lock);
+        sleeping.fetch_add(1, std::memory_order_seq_cst);
+        signal.wait(guard, [this] {
+            return queued.load(std::memory_order_seq_cst) > 0 || finished();
+        });
+        sleeping.fetch_sub(1, std::memory_order_acq_rel);
+
+        // running task can free to pool of this thread: wait all
+        if(finished()) {
+            break;
+        }
+    }
+
+    owner = nullptr;
+}
+
+bool thread_pool::finished() const noexcept {
+    return stop.load(std::memory_order_relaxed) && pending.load(std::memory_order_acquire) == 0;
+}
+
+bool thread_pool::next(size_t self, task** out) noexcept {
+    if(workers[self].queue.take(out)) {
+        return true;
+    }
+    if(inject.pop(out)) {
+        return true;
+    }
+    for(size_t i = 1; i < count; ++i) {
+        if(workers[(self + i) % count].queue.steal(out)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace exec
+} // namespace lwe
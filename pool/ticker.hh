@@ -0,0 +1,60 @@
+#ifndef LWE_TICKER_HEADER
+#define LWE_TICKER_HEADER
+
+#include "config.hh"
+
+#include <chrono>
+#include <functional>
+#include <condition_variable>
+
+namespace lwe {
+namespace util {
+
+/*******************************************************************************
+ * periodic background thread
+ *
+ * - calls fn, then sleeps period or until stop().
+ * - used by maintainer and pressure.
+ *
+ * @code {.cpp}
+ *  ticker loop;
+ *  loop.start(std::chrono::milliseconds(100), [] { ... });
+ *  loop.stop();
+ * @endcode
+ ******************************************************************************/
+class ticker {
+public:
+    ticker(const ticker&)            = delete;
+    ticker& operator=(const ticker&) = delete;
+    ticker(ticker&&)                 = delete;
+    ticker& operator=(ticker&&)      = delete;
+
+public:
+    ticker() noexcept = default;
+
+public:
+    /// @brief stop thread
+    ~ticker() noexcept;
+
+public:
+    /// @brief start background thread, restart when running
+    /// @param [in] period - interval between calls
+    /// @param [in] fn     - called on background thread
+    void start(std::chrono::milliseconds period, std::function<void()> fn);
+
+public:
+    /// @brief stop background thread and join
+    void stop() noexcept;
+
+private:
+    std::thread             thread;
+    std::mutex              lock;
+    std::condition_variable signal;
+    bool                    running = false;
+};
+
+} // namespace util
+} // namespace lwe
+
+#include "ticker.inl"
+#endif
@@ -0,0 +1,38 @@
+#include "ticker.hh"
+
+namespace lwe {
+namespace util {
+
+ticker::~ticker() noexcept {
+    stop();
+}
+
+void ticker::start(std::chrono::milliseconds period, std::function<void()> fn) {
+    stop();
+
+    running = true;
+    thread  = std::thread([this, period, fn = std::move(fn)] {
+        std::unique_lock<std::mutex> guard(lock);
+        while(running) {
+            guard.unlock();
+            fn();
+            guard.lock();
+            signal.wait_for(guard, period, [this] { return !running; });
+        }
+    });
+}
+
+void ticker::stop() noexcept {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        running = false;
+    }
+    signal.notify_all();
+
+    if(thread.joinable()) {
+        thread.join();
+    }
+}
+
+} // namespace util
+} // namespace lwe
@@ -0,0 +1,74 @@
+#include "check.hh"
+
+#include "thread"
+#include "../pool/pool.hh"
+
+using namespace lwe::mem;
+
+enum { E_MALLOC = 1, E_LATE = 2, E_DEQUE = 3, E_POOL = 4 };
+
+// free in other scope: uncounted from tag of malloc
+void scoped() {
+    void* ptr = nullptr;
+    {
+        account::scope tag(E_MALLOC);
+        ptr = allocator::malloc(100, 64);
+    }
+    CHECK(reinterpret_cast<uintptr_t>(ptr) % 64 == 0);
+    CHECK(account::total(E_MALLOC).bytes == 100);
+
+    allocator::free(ptr);
+    CHECK(account::total(E_MALLOC).bytes == 0);
+    CHECK(account::total(E_MALLOC).count == 0);
+    CHECK(account::total(0).bytes == 0);
+}
+
+// thread local destroyed after counter of thread
+struct late {
+    void* ptr = nullptr;
+    ~late() { allocator::free(ptr); }
+};
+
+void ended() {
+    std::thread thread([] {
+        static thread_local late keep; // constructed first: destroyed last
+        account::scope tag(E_LATE);
+        keep.ptr = allocator::malloc(100);
+    });
+    thread.join();
+    CHECK(account::total(E_LATE).bytes == 0);
+    CHECK(account::total(E_LATE).count == 0);
+}
+
+// container internals are not counted to user tag
+void internal() {
+    lwe::data::deque<int> queue;
+    {
+        account::scope tag(E_DEQUE);
+        for(int i = 0; i < 100000; ++i) {
+            queue.push(i);
+        }
+    }
+    CHECK(account::total(E_DEQUE).bytes == 0);
+}
+
+// pool chunks: tag of pool, freed on other thread
+void remote() {
+    pool  local(64, 8, 64, E_POOL);
+    void* ptr = local.construct();
+    CHECK(account::total(E_POOL).count == 1);
+
+    std::thread thread([ptr] { pool::release(ptr); });
+    thread.join();
+    local.cleanup();
+    CHECK(account::total(E_POOL).count == 0);
+    CHECK(account::total(E_POOL).bytes == 0);
+}
+
+int main() {
+    scoped();
+    ended();
+    internal();
+    remote();
+    return RESULT();
+}
@@ -0,0 +1,103 @@
+#include "chrono"
+#include "thread"
+#include "vector"
+#include "atomic"
+#include "cstdio"
+#include "../pool/mpmc.hh"
+#include "thirdparty/concurrentqueue/concurrentqueue.h"
+
+#define LINE() printf("==============================================================================\n");
+
+//======================================================================================================================
+// config
+//======================================================================================================================
+constexpr size_t BENCH_PRODUCERS = 4;       // thread count
+constexpr size_t BENCH_CONSUMERS = 4;       // thread count
+constexpr size_t BENCH_COUNT     = 1000000; // per producer
+constexpr size_t BENCH_BULK      = 32;      // bulk size
+constexpr size_t BENCH_LOOP      = 5;       // for average
+
+//======================================================================================================================
+// same interface: push / pop, single and bulk
+//======================================================================================================================
+struct native {
+    lwe::data::mpmc_queue<size_t> queue;
+    size_t push(const size_t* in, size_t n) { return n == 1 ? queue.push(*in) : queue.push(in, n); }
+    size_t pop(size_t* out, size_t n) { return n == 1 ? queue.pop(out) : queue.pop(out, n); }
+};
+
+struct ring {
+    lwe::data::mpmc_ring<size_t> queue{ 1 << 16 };
+    size_t push(const size_t* in, size_t n) { return n == 1 ? queue.push(*in) : queue.push(in, n); }
+    size_t pop(size_t* out, size_t n) { return n == 1 ? queue.pop(out) : queue.pop(out, n); }
+};
+
+struct moody {
+    moodycamel::ConcurrentQueue<size_t> queue;
+    size_t push(const size_t* in, size_t n) { return n == 1 ? queue.enqueue(*in) : (queue.enqueue_bulk(in, n) ? n : 0); }
+    size_t pop(size_t* out, size_t n) { return n == 1 ? queue.try_dequeue(*out) : queue.try_dequeue_bulk(out, n); }
+};
+
+// P producers and C consumers: milliseconds until all popped
+template<typename Q> double run(size_t bulk) {
+    Q                        target;
+    std::atomic<size_t>      popped{ 0 };
+    std::atomic<bool>        go{ false };
+    std::vector<std::thread> threads;
+
+    for(size_t t = 0; t < BENCH_PRODUCERS; ++t) {
+        threads.emplace_back([&] {
+            size_t buffer[BENCH_BULK];
+            while(!go) std::this_thread::yield();
+            for(size_t i = 0; i < BENCH_COUNT;) {
+                size_t n = std::min(bulk, BENCH_COUNT - i);
+                for(size_t j = 0; j < n; ++j) {
+                    buffer[j] = i + j;
+                }
+                size_t done = target.push(buffer, n);
+                i += done;
+                if(done < n) std::this_thread::yield();
+            }
+        });
+    }
+    for(size_t t = 0; t < BENCH_CONSUMERS; ++t) {
+        threads.emplace_back([&] {
+            size_t buffer[BENCH_BULK];
+            while(!go) std::this_thread::yield();
+            while(popped.load(std::memory_order_relaxed) < BENCH_PRODUCERS * BENCH_COUNT) {
+                size_t n = target.pop(buffer, bulk);
+                if(n) popped.fetch_add(n, std::memory_order_relaxed);
+                else std::this_thread::yield();
+            }
+        });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    go         = true;
+    for(auto& t : threads) {
+        t.join();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+template<typename Q> void report(const char* name) {
+    double single = 0, bulk = 0;
+    for(size_t i = 0; i < BENCH_LOOP; ++i) {
+        single += run<Q>(1);
+        bulk   += run<Q>(BENCH_BULK);
+    }
+    printf("%-24s single: %10.3f ms    bulk(%zu): %10.3f ms\n", name, single / BENCH_LOOP, BENCH_BULK, bulk / BENCH_LOOP);
+}
+
+int main() {
+    printf("config\n");
+    printf("Producers: %zu, Consumers: %zu, Count: %zu, Loop: %zu\n",
+           BENCH_PRODUCERS, BENCH_CONSUMERS, BENCH_COUNT, BENCH_LOOP);
+
+    LINE();
+    report<native>("lwe::data::mpmc_queue");
+    report<ring>("lwe::data::mpmc_ring");
+    report<moody>("moodycamel");
+    LINE();
+    return 0;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "cstdio"
+#include "cstdlib"
+
+//======================================================================================================================
+// behaviour tests: one program per file, exit code is failure count
+//======================================================================================================================
+inline int gFailed = 0;
+
+#define CHECK(expr)                                                          \
+    do {                                                                     \
+        if(!(expr)) {                                                        \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #expr);           \
+            ++gFailed;                                                       \
+        }                                                                    \
+    } while(0)
+
+#define RESULT()                                                             \
+    (printf("%s: %s\n", __FILE__, gFailed ? "FAILED" : "OK"), gFailed)
@@ -0,0 +1,113 @@
+#include "check.hh"
+
+#include "../pool/pool.hh"
+
+using namespace lwe::mem;
+
+constexpr size_t COUNT  = lwe::config::DEF_CACHE; // count is padded to it
+constexpr size_t BLOCKS = 8;
+
+struct object {
+    size_t   value;
+    object** back; // handle to fix on relocate
+};
+
+object* gHandles[COUNT * BLOCKS];
+
+void relocate(void* from, void* to) {
+    object* in  = static_cast<object*>(from);
+    object* out = new(to) object(*in);
+    *out->back  = out;
+}
+
+// sparse blocks are moved into dense ones, contents and handles follow
+void moved() {
+    pool target(sizeof(object), alignof(object), COUNT);
+    for(size_t i = 0; i < COUNT * BLOCKS; ++i) {
+        gHandles[i] = target.construct<object>(i, &gHandles[i]);
+    }
+    size_t bytes = target.limits().usage();
+    size_t total = bytes / BLOCKS;
+
+    // blocks 0 ~ 3: a quarter free, blocks 4 ~ 7: 8 live each
+    size_t live = 0;
+    for(size_t i = 0; i < COUNT * BLOCKS; ++i) {
+        size_t index = i % COUNT;
+        bool   keep  = i < COUNT * 4 ? index >= COUNT / 4 : index < 8;
+        if(!keep) {
+            target.destruct(gHandles[i]);
+            gHandles[i] = nullptr;
+        } else ++live;
+    }
+
+    CHECK(target.compact(relocate) == 4);
+    CHECK(target.limits().usage() == bytes - total * 4);
+
+    size_t found = 0;
+    for(size_t i = 0; i < COUNT * BLOCKS; ++i) {
+        if(gHandles[i]) {
+            CHECK(gHandles[i]->value == i);
+            CHECK(gHandles[i]->back == &gHandles[i]);
+            CHECK(target.owns(gHandles[i]));
+            ++found;
+        }
+    }
+    CHECK(found == live);
+
+    // nothing sparse is left
+    CHECK(target.compact(relocate) == 0);
+
+    for(object*& i : gHandles) {
+        target.destruct(i);
+        i = nullptr;
+    }
+}
+
+// destination is full before sparse block is emptied: stops, pool is usable
+void partial() {
+    pool target(sizeof(object), alignof(object), COUNT);
+    for(size_t i = 0; i < COUNT * BLOCKS; ++i) {
+        gHandles[i] = target.construct<object>(i, &gHandles[i]);
+    }
+    size_t bytes = target.limits().usage();
+
+    // block 0: 4 free, block 1: 10 live, others full
+    for(size_t i = 0; i < COUNT * 2; ++i) {
+        size_t index = i % COUNT;
+        bool   keep  = i < COUNT ? index >= 4 : index < 10;
+        if(!keep) {
+            target.destruct(gHandles[i]);
+            gHandles[i] = nullptr;
+        }
+    }
+
+    CHECK(target.compact(relocate) == 0);
+    CHECK(target.limits().usage() == bytes);
+
+    for(size_t i = 0; i < COUNT * BLOCKS; ++i) {
+        if(gHandles[i]) {
+            CHECK(gHandles[i]->value == i);
+            CHECK(target.owns(gHandles[i]));
+        }
+    }
+
+    // free chunks are not left tagged: reused, owned
+    for(size_t i = 0; i < COUNT * BLOCKS; ++i) {
+        if(!gHandles[i]) {
+            gHandles[i] = target.construct<object>(i, &gHandles[i]);
+            CHECK(target.owns(gHandles[i]));
+        }
+    }
+    CHECK(target.limits().usage() == bytes);
+
+    for(object*& i : gHandles) {
+        target.destruct(i);
+        i = nullptr;
+    }
+}
+
+int main() {
+    moved();
+    partial();
+    return RESULT();
+}
@@ -0,0 +1,86 @@
+#include "check.hh"
+
+#include "atomic"
+#include "coroutine"
+#include "thread"
+#include "vector"
+#include "../pool/coro.hh"
+
+using namespace lwe;
+
+std::atomic<size_t> gDestroyed{ 0 };
+
+struct frame {
+    struct promise_type: coro::pooled_promise {
+        ~promise_type() { gDestroyed.fetch_add(1, std::memory_order_relaxed); }
+
+        frame               get_return_object() { return { std::coroutine_handle<promise_type>::from_promise(*this) }; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void                return_void() noexcept {}
+        void                unhandled_exception() noexcept {}
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+frame spawn(size_t value) {
+    volatile size_t keep = value; // frame is not elided
+    (void)keep;
+    co_return;
+}
+
+constexpr size_t FRAMES = 4096;
+constexpr size_t ROUNDS = 50;
+
+// creating thread ends while its frames are destroyed on other thread
+void handover() {
+    size_t before = mem::quota::global().usage();
+
+    for(size_t round = 0; round < ROUNDS; ++round) {
+        std::vector<std::coroutine_handle<>> handles(FRAMES);
+        std::atomic<bool>                    ready{ false };
+        std::atomic<size_t>                  taken{ 0 };
+
+        std::thread creator([&] {
+            for(size_t i = 0; i < FRAMES; ++i) {
+                handles[i] = spawn(i).handle;
+            }
+            ready.store(true, std::memory_order_release);
+
+            // end while the other thread is releasing
+            while(taken.load(std::memory_order_acquire) < FRAMES / 4) {
+                std::this_thread::yield();
+            }
+        });
+        std::thread destroyer([&] {
+            while(!ready.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for(size_t i = 0; i < FRAMES; ++i) {
+                handles[i].destroy();
+                taken.fetch_add(1, std::memory_order_release);
+            }
+        });
+        creator.join();
+        destroyer.join();
+    }
+
+    CHECK(gDestroyed.load() == FRAMES * ROUNDS);
+    CHECK(mem::quota::global().usage() == before); // heirs are freed
+}
+
+// destroyed on creating thread: recycled at once
+void local() {
+    size_t done = gDestroyed.load();
+    for(size_t i = 0; i < FRAMES; ++i) {
+        spawn(i).handle.destroy();
+    }
+    CHECK(gDestroyed.load() - done == FRAMES);
+}
+
+int main() {
+    handover();
+    local();
+    return RESULT();
+}
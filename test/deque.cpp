@@ -0,0 +1,326 @@
+#include "check.hh"
+
+#include "fcntl.h"
+#include "string"
+#include "unistd.h"
+#include "../pool/deque.hh"
+
+using namespace lwe::data;
+
+struct record {
+    uint64_t id;
+    uint32_t value;
+    uint32_t flag;
+};
+
+// element split across reads: bytes are carried, not dropped
+void partial() {
+    int fds[2];
+    if(pipe(fds) != 0) {
+        CHECK(false);
+        return;
+    }
+    fcntl(fds[0], F_SETFL, O_NONBLOCK); // short read stops at EAGAIN
+
+    record in[5];
+    for(uint32_t i = 0; i < 5; ++i) {
+        in[i] = { i, i * 10, 1 };
+    }
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(in);
+
+    deque<record, 4>            out;
+    deque<record, 4>::remainder rest;
+
+    // 2.5 elements
+    CHECK(write(fds[1], bytes, sizeof(record) * 2 + 7) == ssize_t(sizeof(record) * 2 + 7));
+    CHECK(out.read_from(fds[0], 2, &rest) == 2);
+    CHECK(rest.size == 0);
+
+    CHECK(out.read_from(fds[0], 3, &rest) == 0);
+    CHECK(rest.size == 7);
+
+    // rest: crosses node boundary of Size 4
+    CHECK(write(fds[1], bytes + sizeof(record) * 2 + 7, sizeof(record) * 3 - 7) == ssize_t(sizeof(record) * 3 - 7));
+    close(fds[1]);
+    CHECK(out.read_from(fds[0], 8, &rest) == 3);
+    CHECK(rest.size == 0);
+    close(fds[0]);
+
+    CHECK(out.size() == 5);
+    for(uint32_t i = 0; i < 5 && i < out.size(); ++i) {
+        CHECK(out[i].id == i && out[i].value == i * 10 && out[i].flag == 1);
+    }
+}
+
+// inline first node: no allocation within one node
+void embedded() {
+    deque<int, 8, 8, 4, true> small;
+    for(int i = 0; i < 8; ++i) {
+        small.push(i);
+    }
+    CHECK(small.report().misses == 0);
+    for(int i = 8; i < 100; ++i) {
+        small.push(i);
+    }
+    int sum = 0;
+    for(int i : small) {
+        sum += i;
+    }
+    CHECK(sum == 4950);
+}
+
+// heap map: not allocated by single node deque, allocated with second node
+void lazy() {
+    using type = deque<int, 16>;
+    {
+        type warm; // cache nodes of this thread
+        for(int i = 0; i < 16 * 8; ++i) {
+            warm.push(i);
+        }
+    }
+
+    size_t before = lwe::mem::quota::global().usage();
+    {
+        type one;
+        for(int i = 0; i < 16; ++i) {
+            one.push(i);
+        }
+        CHECK(one[15] == 15);
+        CHECK(lwe::mem::quota::global().usage() == before);
+
+        one.push(16); // second node: map
+        CHECK(lwe::mem::quota::global().usage() > before);
+        for(int i = 0; i < 17; ++i) {
+            CHECK(one[i] == i);
+        }
+
+        // front: map is allocated in front of first too
+        type front;
+        front.push_front(1);
+        for(int i = 2; i <= 40; ++i) {
+            front.push_front(i);
+        }
+        CHECK(front[0] == 40 && front[39] == 1);
+    }
+    CHECK(lwe::mem::quota::global().usage() == before);
+}
+
+struct counted {
+    static inline int built  = 0; // from arguments
+    static inline int copies = 0;
+    static inline int moves  = 0;
+    static inline int alive  = 0;
+
+    static void clear() { built = copies = moves = 0; }
+
+    counted(int a = 0, int b = 0): value(a + b) { ++built, ++alive; }
+    counted(const counted& in): value(in.value) { ++copies, ++alive; }
+    counted(counted&& in) noexcept: value(in.value) { ++moves, ++alive; }
+    counted& operator=(const counted& in) { return ++copies, value = in.value, *this; }
+    counted& operator=(counted&& in) noexcept { return ++moves, value = in.value, *this; }
+    ~counted() { --alive; }
+
+    int value;
+};
+
+// bulk push and pop by node segment: order is kept across nodes
+void ranges() {
+    int in[100];
+    for(int i = 0; i < 100; ++i) {
+        in[i] = i;
+    }
+
+    deque<int, 16> values;
+    values.push(-1);
+    CHECK(values.push_range(in, 100));
+    CHECK(values.push_range(in, 0));
+    CHECK(values.size() == 101);
+    for(size_t i = 1; i < values.size(); ++i) {
+        CHECK(values[i] == int(i) - 1);
+    }
+
+    int out[100] = {};
+    CHECK(values.pop_front_n(out, 20) == 20);
+    CHECK(out[0] == -1 && out[19] == 18);
+
+    // out[0] is frontmost of popped ones
+    CHECK(values.pop_back_n(out, 30) == 30);
+    for(int i = 0; i < 30; ++i) {
+        CHECK(out[i] == 70 + i);
+    }
+    CHECK(*values.front() == 19 && *values.top() == 69);
+
+    // less than n at empty
+    CHECK(values.pop_back_n(out, 100) == 51);
+    CHECK(out[0] == 19 && out[50] == 69);
+    CHECK(values.pop_front_n(out, 10) == 0);
+    CHECK(values.size() == 0);
+
+    // not trivially copyable: copied, source is kept
+    std::string           text[40];
+    deque<std::string, 8> strings;
+    for(int i = 0; i < 40; ++i) {
+        text[i] = std::string(32, char('a' + i % 26));
+    }
+    CHECK(strings.push_range(text, 40));
+    CHECK(strings.size() == 40 && strings[39] == text[39] && text[39].size() == 32);
+
+    std::string moved[40];
+    CHECK(strings.pop_front_n(moved, 40) == 40);
+    CHECK(moved[0] == text[0] && moved[39] == text[39]);
+}
+
+// after reserve: no node from cache, no map allocation
+void reserved() {
+    deque<int, 16> values;
+    values.push(0);
+
+    size_t before = lwe::mem::quota::global().usage();
+    CHECK(values.reserve(1000));
+    CHECK(lwe::mem::quota::global().usage() > before);
+
+    auto   taken = values.report();
+    size_t after = lwe::mem::quota::global().usage();
+    for(int i = 1; i <= 1000; ++i) {
+        values.push(i);
+    }
+    CHECK(lwe::mem::quota::global().usage() == after);
+    CHECK(values.report().hits == taken.hits && values.report().misses == taken.misses);
+
+    // push_range within reserve: same
+    deque<int, 16> range;
+    int            in[500] = {};
+    CHECK(range.reserve(500));
+    after = lwe::mem::quota::global().usage();
+    CHECK(range.push_range(in, 500));
+    CHECK(lwe::mem::quota::global().usage() == after);
+    CHECK(values[1000] == 1000 && range.size() == 500);
+}
+
+// push front: reverse order across node boundaries, mixed with push back
+void fronts() {
+    deque<int, 8> values;
+    for(int i = 0; i < 50; ++i) {
+        values.push_front(i);
+    }
+    for(int i = 0; i < 50; ++i) {
+        CHECK(values[i] == 49 - i);
+    }
+
+    for(int i = 50; i < 60; ++i) {
+        values.push(i);
+    }
+    CHECK(*values.front() == 49 && *values.top() == 59 && values[49] == 0 && values[50] == 50);
+
+    int expect = 49;
+    int out    = 0;
+    while(expect >= 0 && values.fifo(&out)) {
+        CHECK(out == expect--);
+    }
+    CHECK(values.size() == 10 && *values.front() == 50);
+
+    // emplace front: constructed in place, same order
+    deque<record, 4> records;
+    for(uint32_t i = 0; i < 10; ++i) {
+        CHECK(records.emplace_front(record{ i, i * 10, 0 }));
+    }
+    records.emplace_back(record{ 100, 1000, 1 });
+    for(uint32_t i = 0; i < 10; ++i) {
+        CHECK(records[i].id == 9 - i && records[i].value == (9 - i) * 10);
+    }
+    CHECK(records[10].id == 100 && records[10].flag == 1);
+
+    // back to front by lifo: push order
+    uint32_t id = 100;
+    record   last{};
+    CHECK(records.lifo(&last) && last.id == id);
+    for(id = 0; records.lifo(&last); ++id) {
+        CHECK(last.id == id);
+    }
+    CHECK(id == 10);
+}
+
+// emplace: built in place, pop: moved out, never copied
+void inplace() {
+    {
+        deque<counted, 4> values;
+        counted::clear();
+        for(int i = 0; i < 10; ++i) {
+            CHECK(values.emplace_back(i, 1));
+            CHECK(values.emplace_front(i, 2));
+        }
+        CHECK(counted::built == 20 && counted::copies == 0 && counted::moves == 0);
+        CHECK(counted::alive == 20);
+
+        counted item;
+        counted::clear();
+        CHECK(values.push(item)); // lvalue: one copy
+        CHECK(counted::copies == 1 && counted::moves == 0);
+        CHECK(values.push(counted(5, 7))); // rvalue: one move
+        CHECK(counted::copies == 1 && counted::moves == 1);
+
+        counted::clear();
+        CHECK(values.fifo(&item) && item.value == 11);
+        CHECK(values.lifo(&item) && item.value == 12);
+        CHECK(counted::moves == 2 && counted::copies == 0);
+
+        // nullptr: destroyed, not moved
+        CHECK(values.fifo() && values.lifo());
+        CHECK(counted::moves == 2);
+
+        counted out[8];
+        counted::clear();
+        CHECK(values.pop_front_n(out, 8) == 8);
+        CHECK(counted::moves == 8 && counted::copies == 0);
+        CHECK(counted::alive == 8 + 10 + 1); // out, in deque, item
+    }
+    CHECK(counted::alive == 0); // destructor for rest
+}
+
+// shared node cache: kept up to its depth, reused by any deque given it
+void shared() {
+    node_cache<int, 16> small(4);
+    {
+        deque<int, 16> a(small);
+        deque<int, 16> b(small);
+        for(int i = 0; i < 16 * 10; ++i) {
+            a.push(i);
+            b.push(i);
+        }
+        CHECK(a.report().misses == 20 && a.report().hits == 0);
+        CHECK(b.report().misses == a.report().misses); // same counter
+    }
+    CHECK(small.report().cached == 4); // rest is freed
+
+    auto before = small.report();
+    {
+        deque<int, 16> c(small);
+        for(int i = 0; i < 16 * 6; ++i) {
+            c.push(i);
+        }
+        CHECK(c.report().hits - before.hits == 4);
+        CHECK(c.report().misses - before.misses == 2);
+        CHECK(c.report().cached == 0);
+
+        // popped node goes back to cache, taken by next grow
+        for(int i = 0; i < 16; ++i) {
+            c.fifo();
+        }
+        CHECK(small.report().cached == 1);
+        c.push(0);
+        CHECK(small.report().cached == 0 && small.report().hits - before.hits == 5);
+    }
+    CHECK(small.report().cached == 4);
+}
+
+int main() {
+    partial();
+    embedded();
+    lazy();
+    ranges();
+    reserved();
+    fronts();
+    inplace();
+    shared();
+    return RESULT();
+}
@@ -0,0 +1,146 @@
+#include "check.hh"
+
+#include "atomic"
+#include "thread"
+#include "vector"
+#include "../pool/epoch.hh"
+
+using namespace lwe::mem;
+
+std::atomic<size_t> gDestroyed{ 0 };
+size_t              gRetired = 0;
+
+struct node {
+    size_t value;
+    ~node() { ++gDestroyed; }
+};
+
+pool& nodes() {
+    return pool::statics<sizeof(node), alignof(node)>();
+}
+
+// reader holds old epoch: retired object must not be destroyed
+void reader() {
+    epoch  domain(1);
+    size_t before = gDestroyed;
+
+    std::atomic<int> stage{ 0 };
+    std::thread      other([&] {
+        epoch::guard lock(domain);
+        stage = 1;
+        while(stage != 2) std::this_thread::yield();
+    });
+    while(stage != 1) std::this_thread::yield();
+
+    domain.retire(nodes().construct<node>());
+    for(int i = 0; i < 4; ++i) {
+        domain.collect();
+    }
+    CHECK(gDestroyed == before);
+
+    stage = 2;
+    other.join();
+    for(int i = 0; i < 4; ++i) {
+        domain.collect();
+    }
+    CHECK(gDestroyed == before + 1);
+}
+
+// thread retires and ends: its own pool is destroyed before items are collected
+void ended() {
+    epoch  domain(1000);
+    size_t before = gDestroyed;
+
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for(int i = 0; i < 1000; ++i) {
+                epoch::guard lock(domain);
+                domain.retire(nodes().construct<node>());
+            }
+        });
+    }
+    for(auto& t : threads) {
+        t.join();
+    }
+
+    for(int i = 0; i < 4; ++i) {
+        domain.collect();
+    }
+    CHECK(gDestroyed == before + 4000);
+}
+
+// same thread: chunk is recycled at once, not by gc
+void recycle() {
+    node* a = nodes().construct<node>();
+    pool::release(a);
+    node* b = nodes().construct<node>();
+    CHECK(a == b);
+    pool::release(b);
+}
+
+// retired list can not grow: destroyed at once after reader leaves, not dropped
+void exhausted() {
+    constexpr size_t COUNT = 4096;
+
+    epoch  domain(COUNT * 2); // no collect by batch
+    size_t before = gDestroyed;
+
+    std::vector<node*> list;
+    for(size_t i = 0; i < COUNT; ++i) {
+        list.push_back(nodes().construct<node>());
+    }
+
+    std::atomic<int>  stage{ 0 };
+    std::atomic<bool> left{ false };
+    std::thread       other([&] {
+        {
+            epoch::guard lock(domain);
+            stage = 1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            left = true;
+        }
+        while(stage != 2) std::this_thread::yield();
+    });
+    while(stage != 1) std::this_thread::yield();
+
+    quota::global().set(0, quota::global().usage()); // retired list node can not be allocated
+    for(node* ptr : list) {
+        domain.retire(ptr);
+        if(gDestroyed != before) {
+            CHECK(left); // waited reader
+        }
+    }
+    quota::global().set(0, 0);
+    CHECK(gDestroyed > before); // returned without queue
+
+    stage = 2;
+    other.join();
+    for(int i = 0; i < 4; ++i) {
+        domain.collect();
+    }
+    CHECK(gDestroyed == before + COUNT);
+}
+
+// at exit: statics pool of main is destroyed before global domain
+void check() {
+    if(gDestroyed != gRetired) {
+        printf("FAIL exit: %zu of %zu destroyed\n", size_t(gDestroyed), gRetired);
+        _Exit(1);
+    }
+}
+
+int main() {
+    std::atexit(check); // runs after epoch::global() is destroyed
+
+    reader();
+    ended();
+    recycle();
+    exhausted();
+
+    gRetired = gDestroyed + 100;
+    for(int i = 0; i < 100; ++i) {
+        epoch::global().retire(nodes().construct<node>());
+    }
+    return RESULT();
+}
@@ -0,0 +1,111 @@
+#include "check.hh"
+
+#include "atomic"
+#include "thread"
+#include "vector"
+#include "../pool/chaselev.hh"
+#include "../pool/thread_pool.hh"
+
+using namespace lwe;
+
+constexpr size_t COUNT = 100000;
+
+// owner push / take, thieves steal: every value once
+void stealing() {
+    data::chaselev<size_t>            deque;
+    std::vector<std::atomic<uint8_t>> seen(COUNT);
+    std::atomic<bool>                 done{ false };
+    std::vector<std::thread>          thieves;
+
+    for(int t = 0; t < 3; ++t) {
+        thieves.emplace_back([&] {
+            size_t out;
+            while(!done || deque.size()) {
+                if(deque.steal(&out)) {
+                    seen[out].fetch_add(1);
+                } else std::this_thread::yield();
+            }
+        });
+    }
+
+    // grows past initial Size
+    size_t out;
+    for(size_t i = 0; i < COUNT; ++i) {
+        CHECK(deque.push(i));
+        if(i % 3 == 0 && deque.take(&out)) {
+            seen[out].fetch_add(1);
+        }
+    }
+    while(deque.take(&out)) {
+        seen[out].fetch_add(1);
+    }
+    done = true;
+    for(auto& t : thieves) {
+        t.join();
+    }
+
+    size_t once = 0;
+    for(auto& i : seen) {
+        once += i.load() == 1;
+    }
+    CHECK(once == COUNT);
+}
+
+// grown nodes are linked from the new one: charged once each, freed by destructor
+void grown() {
+    size_t before = mem::quota::global().usage();
+    size_t bytes  = 0;
+    {
+        data::chaselev<size_t, 8> deque;
+        for(size_t i = 0; i < 4096; ++i) {
+            CHECK(deque.push(i));
+        }
+        for(size_t capacity = 8; capacity <= 4096; capacity <<= 1) {
+            bytes += sizeof(size_t) + sizeof(void*) + sizeof(size_t) * capacity;
+        }
+        CHECK(mem::quota::global().usage() - before == bytes);
+
+        size_t out = 0;
+        for(size_t i = 4096; i-- > 0;) {
+            CHECK(deque.take(&out) && out == i);
+        }
+    }
+    CHECK(mem::quota::global().usage() == before);
+}
+
+// submit and wait in small bursts: lost wakeup leaves wait() blocked
+void wakeup() {
+    std::atomic<size_t> ran{ 0 };
+    exec::thread_pool   pool(4);
+    for(size_t i = 0; i < 20000; ++i) {
+        pool.submit([&] { ++ran; });
+        pool.wait();
+    }
+    CHECK(ran == 20000);
+}
+
+// tasks submitted from workers go to own deque and are stolen
+void nested() {
+    std::atomic<size_t> ran{ 0 };
+    {
+        exec::thread_pool pool(4);
+        for(int i = 0; i < 100; ++i) {
+            pool.submit([&] {
+                for(int j = 0; j < 100; ++j) {
+                    pool.submit([&] { ++ran; });
+                }
+            });
+        }
+        pool.wait();
+        CHECK(ran == 10000);
+    }
+    CHECK(ran == 10000);
+}
+
+int main() {
+    stealing();
+    grown();
+    wakeup();
+    nested();
+    return RESULT();
+}
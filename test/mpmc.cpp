@@ -0,0 +1,128 @@
+#include "check.hh"
+
+#include "atomic"
+#include "thread"
+#include "vector"
+#include "../pool/mpmc.hh"
+
+using namespace lwe::data;
+
+constexpr size_t THREADS = 4;
+constexpr size_t COUNT   = 100000; // per producer
+
+// every pushed value is popped once: P producers, C consumers
+template<typename Q> void exchange(Q& queue, size_t bulk) {
+    std::vector<std::atomic<uint8_t>> seen(THREADS * COUNT);
+    std::atomic<size_t>               popped{ 0 };
+    std::vector<std::thread>          threads;
+
+    for(size_t t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&, t] {
+            size_t buffer[64];
+            for(size_t i = 0; i < COUNT;) {
+                size_t n = std::min(bulk, COUNT - i);
+                for(size_t j = 0; j < n; ++j) {
+                    buffer[j] = t * COUNT + i + j;
+                }
+                size_t done = queue.push(buffer, n); // ring: can be full
+                i          += done;
+                if(done < n) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        threads.emplace_back([&] {
+            size_t buffer[64];
+            while(popped.load() < THREADS * COUNT) {
+                size_t n = queue.pop(buffer, bulk);
+                for(size_t j = 0; j < n; ++j) {
+                    seen[buffer[j]].fetch_add(1);
+                }
+                popped += n;
+                if(n == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for(auto& t : threads) {
+        t.join();
+    }
+
+    size_t once = 0;
+    for(auto& i : seen) {
+        once += i.load() == 1;
+    }
+    CHECK(once == THREADS * COUNT);
+    CHECK(queue.empty());
+}
+
+void queue() {
+    mpmc_queue<size_t, 32> single, bulk;
+    exchange(single, 1);
+    exchange(bulk, 64);
+}
+
+void ring() {
+    mpmc_ring<size_t> single(64), bulk(256);
+    CHECK(single.capacity() == 64);
+    exchange(single, 1);
+    exchange(bulk, 64);
+
+    // full: refused, not overwritten
+    mpmc_ring<size_t> small(8);
+    size_t            in[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+    CHECK(small.push(in, 16) == 8);
+    CHECK(!small.push(size_t(99)));
+
+    size_t out[16] = {};
+    CHECK(small.pop(out, 16) == 8);
+    CHECK(out[0] == 0 && out[7] == 7);
+    CHECK(!small.pop(out));
+
+    // wraps around: run is split at ready cells only
+    CHECK(small.push(in, 5) == 5);
+    CHECK(small.pop(out, 3) == 3 && out[2] == 2);
+    CHECK(small.push(in + 5, 16) == 6);
+    CHECK(small.pop(out, 16) == 8);
+    CHECK(out[0] == 3 && out[1] == 4 && out[2] == 5 && out[7] == 10);
+
+    // nullptr: discarded
+    CHECK(small.push(in, 4) == 4);
+    CHECK(small.pop(nullptr));
+    CHECK(small.pop(nullptr, 2) == 2);
+    CHECK(small.pop(out) && out[0] == 3);
+    CHECK(small.empty());
+}
+
+// not popped values are destroyed with queue
+struct counted {
+    static inline std::atomic<int> alive{ 0 };
+    counted() { ++alive; }
+    counted(const counted&) { ++alive; }
+    counted& operator=(const counted&) = default;
+    ~counted() { --alive; }
+};
+
+void destroy() {
+    {
+        mpmc_queue<counted, 8> a;
+        mpmc_ring<counted>     b(8);
+        for(int i = 0; i < 20; ++i) {
+            a.push(counted());
+            b.push(counted());
+        }
+        counted out;
+        a.pop(&out);
+        b.pop(&out);
+        b.pop(nullptr, 2);
+    }
+    CHECK(counted::alive == 0);
+}
+
+int main() {
+    queue();
+    ring();
+    destroy();
+    return RESULT();
+}
@@ -0,0 +1,66 @@
+#include "check.hh"
+
+#include "set"
+#include "vector"
+#include "../pool/pool.hh"
+
+using namespace lwe::mem;
+
+constexpr size_t COUNT = lwe::config::DEF_CACHE; // count is padded to it
+
+// chunk comes from block of hint when it has free one
+void near() {
+    pool target(sizeof(long), alignof(long), COUNT);
+
+    std::vector<long*> chunks;
+    for(size_t i = 0; i < COUNT * 3; ++i) {
+        chunks.push_back(target.construct<long>(long(i)));
+    }
+
+    // block 0 and 2 get free chunks, block 1 stays full
+    std::set<long*> block0(chunks.begin(), chunks.begin() + COUNT);
+    std::set<long*> block2(chunks.begin() + COUNT * 2, chunks.end());
+    for(size_t i = 0; i < 8; ++i) {
+        target.destruct(chunks[i * 3]);
+        target.destruct(chunks[COUNT * 2 + i * 3]);
+        chunks[i * 3]             = nullptr;
+        chunks[COUNT * 2 + i * 3] = nullptr;
+    }
+
+    long* hint = chunks[COUNT * 2 + 1];
+    for(size_t i = 0; i < 8; ++i) {
+        long* ptr = target.construct_near<long>(hint, 7L);
+        CHECK(block2.count(ptr) == 1);
+        CHECK(*ptr == 7);
+        chunks.push_back(ptr);
+    }
+
+    // hint block is full: usable block
+    long* full = target.construct_near<long>(hint, 8L);
+    CHECK(block0.count(full) == 1);
+    chunks.push_back(full);
+
+    // full block 1 as hint: usable block
+    long* other = target.construct_near<long>(chunks[COUNT + 5], 9L);
+    CHECK(block0.count(other) == 1);
+    chunks.push_back(other);
+
+    // hint of other pool and nullptr: plain construct
+    pool  foreign(sizeof(long), alignof(long), COUNT);
+    long* away = foreign.construct<long>(1L);
+    long* mine = target.construct_near<long>(away, 2L);
+    CHECK(target.owns(mine) && !foreign.owns(mine));
+    chunks.push_back(mine);
+    chunks.push_back(target.construct_near<long>(nullptr, 3L));
+    CHECK(target.owns(chunks.back()));
+    foreign.destruct(away);
+
+    for(long* ptr : chunks) {
+        target.destruct(ptr);
+    }
+}
+
+int main() {
+    near();
+    return RESULT();
+}
@@ -0,0 +1,90 @@
+#include "check.hh"
+
+#include "atomic"
+#include "vector"
+#include "../pool/parallel.hh"
+
+using namespace lwe;
+
+using values = data::deque<long, 64>;
+
+// front is pushed too: first node is partial
+void fill(values& in, long count) {
+    for(long i = 0; i < count; ++i) {
+        if(i % 3 == 0) {
+            in.push_front(i);
+        } else in.push(i);
+    }
+}
+
+long serial_sum(const values& in) {
+    long out = 7;
+    for(long v : in) {
+        out += v * v;
+    }
+    return out;
+}
+
+// same result as serial on empty, single node and multi node
+void compare(exec::thread_pool& pool) {
+    for(long count : { 0L, 1L, 10L, 64L, 65L, 10000L }) {
+        values in;
+        fill(in, count);
+
+        long expect = serial_sum(in);
+        long got    = data::parallel_transform_reduce(pool, in, 7L, [](const long& v) { return v * v; }, std::plus<>());
+        CHECK(got == expect);
+
+        values copy;
+        fill(copy, count);
+        data::parallel_for_each(pool, in, [](long& v) { v = v * 2 + 1; });
+
+        bool same = in.size() == copy.size();
+        for(size_t i = 0; same && i < in.size(); ++i) {
+            same = in[i] == copy[i] * 2 + 1;
+        }
+        CHECK(same);
+    }
+}
+
+// every element once
+void once(exec::thread_pool& pool) {
+    data::deque<std::atomic<int>*, 16> in;
+    std::vector<std::atomic<int>>      seen(5000);
+    for(auto& i : seen) {
+        in.push(&i);
+    }
+    data::parallel_for_each(pool, in, [](std::atomic<int>*& v) { v->fetch_add(1); });
+
+    size_t single = 0;
+    for(auto& i : seen) {
+        single += i.load() == 1;
+    }
+    CHECK(single == seen.size());
+}
+
+// from worker: caller runs batches, does not wait for busy helpers
+void nested(exec::thread_pool& pool) {
+    std::atomic<long> result{ 0 };
+    pool.submit([&] {
+        values in;
+        fill(in, 5000);
+        result = data::parallel_transform_reduce(pool, in, 7L, [](const long& v) { return v * v; }, std::plus<>());
+    });
+    pool.wait();
+
+    values in;
+    fill(in, 5000);
+    CHECK(result == serial_sum(in));
+}
+
+int main() {
+    exec::thread_pool pool(4);
+    compare(pool);
+    once(pool);
+    nested(pool);
+
+    exec::thread_pool one(1);
+    compare(one);
+    return RESULT();
+}
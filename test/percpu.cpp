@@ -0,0 +1,111 @@
+#include "check.hh"
+
+#include "atomic"
+#include "set"
+#include "thread"
+#include "vector"
+#include "../pool/percpu.hh"
+
+using namespace lwe::mem;
+
+constexpr size_t DEPTH = 16;
+
+// pin calling thread, false when not allowed
+bool pin(size_t cpu) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return ::sched_setaffinity(0, sizeof(set), &set) == 0 && percpu::cpu() == cpu;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+// chunk returned on a cpu is handed out again on same cpu
+void reuse() {
+    percpu target(64, 8, 128, DEPTH);
+    std::thread([&] {
+        if(!pin(0)) {
+            printf("SKIP %s:%d: can not pin thread\n", __FILE__, __LINE__);
+            return;
+        }
+        void* first = target.construct();
+        target.destruct(first);
+        CHECK(target.construct() == first);
+        target.destruct(first);
+    }).join();
+}
+
+// over DEPTH is flushed to central, other cpu refills from it
+void spill() {
+    percpu             target(64, 8, 128, DEPTH);
+    std::set<void*>    returned;
+    std::vector<void*> chunks;
+
+    std::thread([&] {
+        pin(0);
+        for(size_t i = 0; i < DEPTH * 4; ++i) {
+            chunks.push_back(target.construct());
+        }
+        for(void* ptr : chunks) {
+            returned.insert(ptr);
+            target.destruct(ptr);
+        }
+    }).join();
+
+    // cache of cpu 0 or head of central: all are returned ones
+    std::thread([&] {
+        pin(std::thread::hardware_concurrency() > 1 ? 1 : 0);
+        chunks.clear();
+        for(size_t i = 0; i < DEPTH * 3; ++i) {
+            chunks.push_back(target.construct());
+        }
+    }).join();
+
+    size_t found = 0;
+    for(void* ptr : chunks) {
+        found += returned.count(ptr);
+        target.destruct(ptr);
+    }
+    CHECK(found == DEPTH * 3);
+}
+
+// many threads: no chunk is handed out twice
+void concurrent() {
+    size_t before = quota::global().usage();
+    {
+        percpu                   target(sizeof(size_t), 8, 128, DEPTH);
+        std::atomic<size_t>      broken{ 0 };
+        std::vector<std::thread> threads;
+        for(size_t t = 0; t < 8; ++t) {
+            threads.emplace_back([&, t] {
+                std::vector<size_t*> held;
+                for(size_t round = 0; round < 2000; ++round) {
+                    for(size_t i = 0; i < (round % 40) + 1; ++i) {
+                        size_t* ptr = target.construct<size_t>(t);
+                        held.push_back(ptr);
+                    }
+                    for(size_t* ptr : held) {
+                        broken += *ptr != t;
+                        target.destruct(ptr);
+                    }
+                    held.clear();
+                }
+            });
+        }
+        for(auto& thread : threads) {
+            thread.join();
+        }
+        CHECK(broken == 0);
+    }
+    CHECK(quota::global().usage() == before);
+}
+
+int main() {
+    reuse();
+    spill();
+    concurrent();
+    return RESULT();
+}
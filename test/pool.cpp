@@ -0,0 +1,125 @@
+#include "check.hh"
+
+#include "thread"
+#include "vector"
+#include "../pool/pool.hh"
+
+using namespace lwe::mem;
+
+enum { E_SPILL = 1, E_HEIR = 2 };
+
+// gc can not allocate its block: chunks are spilled, not dropped
+void spilled() {
+    pool               local(48, 8, 1024, E_SPILL);
+    std::vector<void*> chunks;
+    for(int i = 0; i < 1000; ++i) {
+        chunks.push_back(local.construct());
+    }
+
+    quota::global().set(0, quota::global().usage()); // malloc fails
+    std::thread thread([&] { pool::release(chunks.data(), chunks.size()); });
+    thread.join();
+
+    // all come back without new block
+    std::vector<void*> again;
+    for(int i = 0; i < 1000; ++i) {
+        void* ptr = local.construct();
+        CHECK(ptr != nullptr);
+        again.push_back(ptr);
+    }
+    quota::global().set(0, 0);
+
+    for(void* ptr : again) {
+        local.destruct(ptr);
+    }
+    CHECK(account::total(E_SPILL).count == 0);
+}
+
+struct tagged {
+    static constexpr size_t account = E_HEIR;
+};
+
+// statics of ended thread: blocks live until last chunk returns
+void inherited() {
+    std::vector<void*> chunks;
+    std::thread        thread([&] {
+        for(int i = 0; i < 1000; ++i) {
+            chunks.push_back(pool::statics<64, 8, 64, tagged>().construct());
+        }
+    });
+    thread.join();
+
+    for(size_t i = 0; i < chunks.size(); i += 2) {
+        pool::release(chunks[i]);
+    }
+    pool::statics<64, 8, 64, tagged>().destruct(chunks[1]); // other pool
+    pool::release(chunks.data() + 3, 1);
+    for(size_t i = 5; i < chunks.size(); i += 2) {
+        pool::release(chunks[i]);
+    }
+    CHECK(account::total(E_HEIR).count == 0);
+}
+
+// release on owner thread: recycled at once
+void owner() {
+    pool& local = pool::statics<32>();
+    void* a     = local.construct();
+    pool::release(a);
+    void* b = local.construct();
+    CHECK(a == b);
+    local.destruct(b);
+}
+
+// owns: any pointer, O(1) with many blocks
+void owns() {
+    pool a(24, 8, 64), b(24, 8, 64);
+
+    // interleaved: foreign allocations fall between blocks of a
+    std::vector<int*>  mine;
+    std::vector<void*> foreign;
+    for(int i = 0; i < 64 * 50; ++i) {
+        mine.push_back(a.construct<int>());
+        if(i % 64 == 0) {
+            foreign.push_back(allocator::malloc(32));
+        }
+    }
+    int* other = b.construct<int>();
+    struct {
+        void* before; // readable word before
+        int   value;
+    } stack = { &stack, 0 };
+
+    size_t owned = 0;
+    for(int* i : mine) {
+        owned += a.owns(i);
+    }
+    CHECK(owned == mine.size());
+    for(void* i : foreign) {
+        CHECK(!a.owns(i));
+    }
+    CHECK(!a.owns(other));
+    CHECK(b.owns(other));
+    CHECK(!a.owns(&stack.value));
+    CHECK(!a.owns(nullptr));
+
+    // inside chunk: word before it is a real block address, offset is wrong
+    uintptr_t* inside = reinterpret_cast<uintptr_t*>(mine[5]);
+    inside[0]         = reinterpret_cast<uintptr_t*>(mine[5])[-1];
+    CHECK(!a.owns(inside + 1));
+
+    for(void* i : foreign) {
+        allocator::free(i);
+    }
+    for(int* i : mine) {
+        a.destruct(i);
+    }
+    b.destruct(other);
+}
+
+int main() {
+    spilled();
+    inherited();
+    owner();
+    owns();
+    return RESULT();
+}
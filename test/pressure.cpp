@@ -0,0 +1,94 @@
+#include "check.hh"
+
+#include "atomic"
+#include "thread"
+#include "unistd.h"
+#include "../pool/pressure.hh"
+
+using namespace lwe::mem;
+
+std::atomic<int> gReclaimed{ 0 };
+
+// stand-in for /proc/pressure/memory, memory.current, memory.events
+void write(const char* path, const char* text) {
+    FILE* file = fopen(path, "w");
+    fputs(text, file);
+    fclose(file);
+}
+
+void psi(const char* path) {
+    pressure watch(pressure::E_PSI, 10.0, path);
+
+    write(path, "some avg10=2.50 avg60=1.00 avg300=0.50 total=100\nfull avg10=0.00 avg60=0.00 avg300=0.00 total=0\n");
+    int before = gReclaimed;
+    CHECK(!watch.poll());
+    CHECK(gReclaimed == before);
+
+    write(path, "some avg10=25.00 avg60=1.00 avg300=0.50 total=100\nfull avg10=0.00 avg60=0.00 avg300=0.00 total=0\n");
+    CHECK(watch.poll());
+    CHECK(gReclaimed == before + 1);
+}
+
+void current(const char* path) {
+    // threshold is bytes: below it must not fire every poll
+    pressure watch(pressure::E_CURRENT, 64 << 20, path);
+
+    write(path, "1048576\n");
+    int before = gReclaimed;
+    CHECK(!watch.poll());
+    CHECK(!watch.poll());
+    CHECK(gReclaimed == before);
+
+    write(path, "134217728\n");
+    CHECK(watch.poll());
+    CHECK(gReclaimed == before + 1);
+}
+
+void events(const char* path) {
+    // baseline at construction is not pressure
+    write(path, "low 0\nhigh 3\nmax 1\noom 0\noom_kill 0\n");
+    pressure watch(pressure::E_EVENTS, 0, path);
+    CHECK(!watch.poll());
+
+    write(path, "low 0\nhigh 4\nmax 1\noom 0\noom_kill 0\n");
+    CHECK(watch.poll());
+    CHECK(!watch.poll()); // not increased
+}
+
+void background(const char* path) {
+    pressure watch(pressure::E_PSI, 10.0, path);
+    write(path, "some avg10=50.00 avg60=1.00 avg300=0.50 total=100\n");
+
+    int before = gReclaimed;
+    watch.start(std::chrono::milliseconds(1));
+    for(int i = 0; i < 1000 && gReclaimed == before; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    watch.stop();
+    CHECK(gReclaimed > before);
+
+    // stopped: no more polls
+    int after = gReclaimed;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    CHECK(gReclaimed == after);
+}
+
+int main() {
+    char path[] = "/tmp/lwe-pressure-XXXXXX";
+    int  fd     = mkstemp(path);
+    if(fd < 0) {
+        return 1;
+    }
+    close(fd);
+
+    size_t id = quota::global().attach([] { ++gReclaimed; });
+
+    psi(path);
+    current(path);
+    events(path);
+    background(path);
+
+    quota::global().detach(id);
+    unlink(path);
+    return RESULT();
+}
@@ -0,0 +1,164 @@
+#include "check.hh"
+
+#include "atomic"
+#include "thread"
+#include "vector"
+#include "../pool/maintainer.hh"
+
+using namespace lwe::mem;
+
+// reclaim only on the charge that crosses soft
+void crossing() {
+    quota local(100, 200);
+    int   calls = 0;
+    local.attach([&] { ++calls; });
+
+    CHECK(local.charge(60));
+    CHECK(calls == 0);
+    CHECK(local.charge(60)); // 120: crossed
+    CHECK(calls == 1);
+    CHECK(local.charge(10)); // over soft: not again
+    CHECK(calls == 1);
+    CHECK(local.exceeded());
+
+    local.uncharge(80); // 50: back under soft
+    CHECK(local.charge(60));
+    CHECK(calls == 2);
+}
+
+// over hard: reclaim once, fails when not freed
+void hard() {
+    quota local(0, 100);
+    int   calls = 0;
+    local.attach([&] { ++calls; });
+
+    CHECK(local.charge(100));
+    CHECK(!local.charge(1));
+    CHECK(calls == 1);
+    CHECK(local.usage() == 100);
+}
+
+// reclaim frees: retry succeeds
+void retry() {
+    quota local(0, 100);
+    local.attach([&] { local.uncharge(50); });
+
+    CHECK(local.charge(100));
+    CHECK(local.charge(20));
+    CHECK(local.usage() == 70);
+}
+
+// tick drains gc, allocation there crosses soft and calls tick again on same thread
+void nested() {
+    pool& target = pool::statics<64>();
+    target.attach();
+
+    std::vector<void*> chunks;
+    for(int i = 0; i < 200000; ++i) {
+        chunks.push_back(target.construct());
+    }
+    std::thread([&] { pool::release(chunks.data(), chunks.size()); }).join();
+
+    maintainer::instance(); // reclaimer
+    quota::global().set(1, 0);
+
+    std::atomic<bool> done{ false };
+    std::thread       thread([&] {
+        maintainer::instance().tick();
+        done = true;
+    });
+    for(int i = 0; i < 10000 && !done; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if(!done) {
+        printf("FAIL %s:%d: tick deadlocked\n", __FILE__, __LINE__);
+        fflush(stdout);
+        _Exit(1);
+    }
+    thread.join();
+    quota::global().set(0, 0);
+    target.detach();
+}
+
+// reclaim inside construct of attached pool: its guard is held by this thread
+void guarded() {
+    maintainer::instance(); // reclaimer
+
+    int               calls = 0;
+    std::atomic<bool> done{ false };
+    std::thread       thread([&] {
+        pool& target = pool::statics<48>();
+        target.attach();
+
+        // release in callback: owner path must not wait own guard
+        void*  first = target.construct();
+        size_t id    = quota::global().attach([&] {
+            if(first) {
+                pool::release(first);
+                first = nullptr;
+            }
+            ++calls;
+        });
+
+        std::vector<void*> chunks;
+        chunks.reserve(4096);
+        quota::global().set(quota::global().usage() + 1, 0);
+        for(int i = 0; i < 4096; ++i) {
+            chunks.push_back(target.construct()); // setup crosses soft
+        }
+        quota::global().set(0, 0);
+        quota::global().detach(id);
+
+        pool::release(chunks.data(), chunks.size());
+        target.detach();
+        done = true;
+    });
+    for(int i = 0; i < 10000 && !done; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if(!done) {
+        printf("FAIL %s:%d: guard of reclaim deadlocked\n", __FILE__, __LINE__);
+        fflush(stdout);
+        _Exit(1);
+    }
+    thread.join();
+    CHECK(calls == 1);
+}
+
+// background thread trims idle blocks of attached pool
+void trimmed() {
+    pool target(64, 8, 64);
+    target.attach();
+
+    std::vector<void*> chunks;
+    for(int i = 0; i < 64 * 8; ++i) {
+        chunks.push_back(target.construct());
+    }
+    for(void* ptr : chunks) {
+        target.destruct(ptr);
+    }
+
+    maintainer::instance().start(std::chrono::milliseconds(1));
+    size_t blocks = 8;
+    for(int i = 0; i < 1000 && blocks > 1; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        for(auto& [from, stat] : maintainer::instance().stats()) {
+            if(from == &target) {
+                blocks = stat.blocks;
+            }
+        }
+    }
+    maintainer::instance().stop();
+    CHECK(blocks <= 1); // top is kept
+    target.detach();
+}
+
+int main() {
+    crossing();
+    hard();
+    retry();
+    nested();
+    guarded();
+    trimmed();
+    return RESULT();
+}
@@ -0,0 +1,101 @@
+#include "check.hh"
+
+#include "vector"
+#include "../pool/simd.hh"
+
+using namespace lwe::util;
+
+constexpr simd::cmp OPS[] = { simd::E_EQ, simd::E_NE, simd::E_LT, simd::E_LE, simd::E_GT, simd::E_GE };
+
+template<typename T> bool test(const T& a, const T& b, simd::cmp op) {
+    switch(op) {
+        case simd::E_EQ: return a == b;
+        case simd::E_NE: return a != b;
+        case simd::E_LT: return a < b;
+        case simd::E_LE: return a <= b;
+        case simd::E_GT: return a > b;
+        case simd::E_GE: return a >= b;
+    }
+    return false;
+}
+
+// every length around lane widths, unaligned start, every compare
+// integral values in float: sum is exact in any order
+template<typename T> void compare(const char* name) {
+    std::vector<T> data(80);
+    for(size_t i = 0; i < data.size(); ++i) {
+        data[i] = T(int((i * 37) % 23) - 11);
+    }
+
+    size_t broken = 0;
+    for(size_t from = 0; from < 3; ++from) {
+        for(size_t n = 0; n + from <= data.size(); ++n) {
+            const T* in = data.data() + from;
+
+            for(simd::cmp op : OPS) {
+                for(T value : { T(-11), T(0), T(5), T(100) }) {
+                    size_t found = n;
+                    size_t count = 0;
+                    for(size_t i = 0; i < n; ++i) {
+                        if(test(in[i], value, op)) {
+                            found  = found == n ? i : found;
+                            count += 1;
+                        }
+                    }
+                    broken += simd::find(in, n, value, op) != found;
+                    broken += simd::count(in, n, value, op) != count;
+                }
+            }
+
+            T sum = T();
+            for(size_t i = 0; i < n; ++i) {
+                sum += in[i];
+            }
+            broken += simd::sum(in, n) != sum;
+
+            if(n > 0) {
+                T low  = in[0];
+                T high = in[0];
+                for(size_t i = 1; i < n; ++i) {
+                    low  = in[i] < low ? in[i] : low;
+                    high = in[i] > high ? in[i] : high;
+                }
+                broken += simd::min(in, n) != low;
+                broken += simd::max(in, n) != high;
+            }
+        }
+    }
+
+    if(broken) {
+        printf("  %s at level %d: %zu mismatches\n", name, int(simd::isa()), broken);
+    }
+    CHECK(broken == 0);
+}
+
+// each level up to cpu support: same result as scalar loop
+void levels() {
+    simd::level top = simd::detect();
+    for(simd::level at : { simd::E_SCALAR, simd::E_SSE2, simd::E_AVX2 }) {
+        if(at > top) {
+            printf("SKIP %s:%d: level %d is not supported\n", __FILE__, __LINE__, int(at));
+            continue;
+        }
+        simd::isa(at);
+        CHECK(simd::isa() == at);
+
+        compare<int32_t>("int32_t");
+        compare<int64_t>("int64_t");
+        compare<float>("float");
+        compare<double>("double");
+        compare<uint16_t>("uint16_t"); // scalar only
+    }
+
+    // clamped to detect
+    simd::isa(simd::E_AVX2);
+    CHECK(simd::isa() == top);
+}
+
+int main() {
+    levels();
+    return RESULT();
+}
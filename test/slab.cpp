@@ -0,0 +1,76 @@
+#include "check.hh"
+
+#include "vector"
+#include "../pool/slab.hh"
+
+using namespace lwe::mem;
+
+struct object {
+    static inline int built  = 0;
+    static inline int killed = 0;
+    static inline int resets = 0;
+
+    object(int in = 0): value(in) { ++built; }
+    ~object() { ++killed; }
+
+    int value;
+    int uses = 0;
+};
+
+void clear(object* in) {
+    in->uses = 0;
+    ++object::resets;
+}
+
+// constructor once per chunk lifetime: reacquire is cached, reset on release
+void lifetime() {
+    {
+        slab<object> cache(clear);
+
+        std::vector<object*> list;
+        for(int i = 0; i < 100; ++i) {
+            object* ptr = cache.acquire(i);
+            ptr->uses   = 1;
+            list.push_back(ptr);
+        }
+        CHECK(object::built == 100);
+
+        for(object* ptr : list) {
+            cache.release(ptr);
+        }
+        CHECK(object::resets == 100);
+        CHECK(object::killed == 0);
+        CHECK(cache.size() == 100);
+
+        // warm: same objects, args are not used, state is reset
+        for(int round = 0; round < 10; ++round) {
+            object* ptr = cache.acquire(-1);
+            CHECK(ptr->uses == 0);
+            CHECK(ptr->value >= 0);
+            ptr->uses = 1;
+            cache.release(ptr);
+        }
+        CHECK(object::built == 100);
+        CHECK(object::resets == 110);
+
+        // lifo: last released is warm
+        object* ptr = cache.acquire();
+        CHECK(ptr == list.back());
+
+        // purge: cached ones only, constructed again after it
+        cache.purge();
+        CHECK(object::killed == 99);
+        CHECK(cache.size() == 0);
+        cache.release(cache.acquire(7));
+        CHECK(object::built == 101);
+
+        cache.release(ptr);
+        CHECK(cache.size() == 2);
+    }
+    CHECK(object::killed == object::built); // destructor purges
+}
+
+int main() {
+    lifetime();
+    return RESULT();
+}
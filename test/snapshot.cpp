@@ -0,0 +1,115 @@
+#include "check.hh"
+
+#include "../pool/snapshot.hh"
+
+using namespace lwe::mem;
+
+constexpr const char* PATH = "/tmp/lwe-snapshot-test.bin";
+
+struct node {
+    size_t value;
+    size_t next; // offset in file
+};
+
+// objects and root survive close and reopen, links by offset
+void reopen() {
+    ::unlink(PATH);
+    {
+        snapshot file(PATH, sizeof(node), alignof(node));
+        CHECK(file.valid());
+        CHECK(file.root<node>() == nullptr);
+
+        node* root = file.construct<node>(size_t(0), size_t(0));
+        node* last = root;
+        for(size_t i = 1; i < 1000; ++i) {
+            node* next = file.construct<node>(i, size_t(0));
+            last->next = file.offset(next);
+            last       = next;
+        }
+        file.root(root);
+        CHECK(file.size() == 1000);
+    }
+    {
+        snapshot file(PATH, sizeof(node), alignof(node));
+        CHECK(file.valid());
+        CHECK(file.size() == 1000);
+
+        size_t count = 0;
+        for(node* i = file.root<node>(); i; i = file.pointer<node>(i->next)) {
+            CHECK(i->value == count);
+            ++count;
+        }
+        CHECK(count == 1000);
+
+        // free list is restored: reused before file grows
+        node* second = file.pointer<node>(file.root<node>()->next);
+        file.root<node>()->next = second->next;
+        file.destruct(second);
+        CHECK(file.construct<node>() == second);
+    }
+    ::unlink(PATH);
+}
+
+// different layout or foreign file: not valid, file is not touched
+void mismatch() {
+    ::unlink(PATH);
+    {
+        snapshot file(PATH, sizeof(node), alignof(node));
+        file.root(file.construct<node>(size_t(7), size_t(0)));
+    }
+    {
+        snapshot file(PATH, sizeof(node) * 4, alignof(node));
+        CHECK(!file.valid());
+        CHECK(file.construct() == nullptr);
+        CHECK(file.root<node>() == nullptr);
+    }
+    {
+        snapshot file(PATH, sizeof(node), alignof(node), 1024);
+        CHECK(!file.valid());
+    }
+    {
+        snapshot file(PATH, sizeof(node), alignof(node));
+        CHECK(file.valid());
+        CHECK(file.root<node>()->value == 7);
+    }
+
+    // not a snapshot
+    int fd = ::open(PATH, O_RDWR | O_TRUNC);
+    CHECK(fd >= 0);
+    char text[8192] = "not a snapshot";
+    CHECK(::write(fd, text, sizeof(text)) == ssize_t(sizeof(text)));
+    ::close(fd);
+    {
+        snapshot file(PATH, sizeof(node), alignof(node));
+        CHECK(!file.valid());
+    }
+    ::unlink(PATH);
+}
+
+// zero chunk / count are clamped: usable, not divided by zero
+void clamped() {
+    ::unlink(PATH);
+    {
+        snapshot file(PATH, 0, 8, 0);
+        CHECK(file.valid());
+
+        void* a = file.construct();
+        void* b = file.construct();
+        CHECK(a && b && a != b);
+        file.destruct(a);
+        file.destruct(b);
+        CHECK(file.size() == 0);
+    }
+    {
+        snapshot file(PATH, 0, 8, 0);
+        CHECK(file.valid());
+    }
+    ::unlink(PATH);
+}
+
+int main() {
+    reopen();
+    mismatch();
+    clamped();
+    return RESULT();
+}
@@ -0,0 +1,94 @@
+#include "check.hh"
+
+#include "thread"
+#include "string"
+#include "../pool/spsc.hh"
+
+using namespace lwe::data;
+
+constexpr size_t COUNT = 1000000;
+
+// order is kept across nodes
+void order() {
+    spsc_queue<size_t> queue;
+    std::thread        producer([&] {
+        for(size_t i = 0; i < COUNT; ++i) {
+            while(!queue.push(i)) std::this_thread::yield();
+        }
+    });
+
+    size_t expect = 0;
+    while(expect < COUNT) {
+        size_t out;
+        if(queue.pop(&out)) {
+            CHECK(out == expect);
+            if(out != expect) {
+                break;
+            }
+            ++expect;
+        } else std::this_thread::yield();
+    }
+    producer.join();
+    CHECK(queue.empty());
+}
+
+// non trivial: moved out, rest destroyed with queue
+void strings() {
+    spsc_queue<std::string> queue;
+    for(int i = 0; i < 1000; ++i) {
+        queue.emplace(std::to_string(i) + " long enough for heap storage");
+    }
+
+    std::string out;
+    for(int i = 0; i < 500; ++i) {
+        CHECK(queue.pop(&out));
+    }
+    CHECK(out == "499 long enough for heap storage");
+}
+
+// warm chain: consumed nodes are reused, allocator is not called
+void warm() {
+    spsc_queue<size_t, 16> queue;
+    for(size_t i = 0; i < 16 * 4; ++i) {
+        queue.push(i);
+    }
+    size_t out;
+    while(queue.pop(&out)) {}
+
+    size_t before = lwe::mem::quota::global().usage();
+    for(size_t round = 0; round < 1000; ++round) {
+        for(size_t i = 0; i < 16 * 3; ++i) {
+            CHECK(queue.push(i));
+        }
+        for(size_t i = 0; i < 16 * 3; ++i) {
+            CHECK(queue.pop(&out) && out == i);
+        }
+    }
+    CHECK(lwe::mem::quota::global().usage() == before);
+}
+
+// first node failed in constructor: empty, allocated by later push
+void failed() {
+    lwe::mem::quota& global = lwe::mem::quota::global();
+    global.set(0, global.usage() + 1);
+    spsc_queue<std::string, 16> queue;
+    CHECK(queue.empty());
+    CHECK(!queue.push(std::string("not pushed")));
+    CHECK(!queue.pop(nullptr));
+    global.set(0, 0);
+
+    CHECK(queue.push(std::string("first")));
+    CHECK(queue.push(std::string("second")));
+    CHECK(!queue.empty());
+
+    std::string out;
+    CHECK(queue.pop(&out) && out == "first");
+}
+
+int main() {
+    order();
+    strings();
+    warm();
+    failed();
+    return RESULT();
+}
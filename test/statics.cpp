@@ -0,0 +1,65 @@
+#include "check.hh"
+
+#include "../pool/pool.hh"
+
+using namespace lwe::mem;
+
+struct order {
+    static constexpr size_t account = 3;
+    char                    data[40];
+};
+
+struct quote {
+    char data[40];
+};
+
+struct book; // tag only
+
+// same size, different tag: different pool and blocks
+void segregated() {
+    pool& plain  = pool::statics<sizeof(order), alignof(order)>();
+    pool& tagged = pool::statics<sizeof(order), alignof(order), lwe::config::DEF_CACHE, book>();
+    pool& orders = pool::statics_for<order>();
+    pool& quotes = pool::statics_for<quote>();
+
+    CHECK(&plain != &tagged);
+    CHECK(&orders != &quotes);
+    CHECK(&orders != &plain);
+    CHECK(&pool::statics_for<order>() == &orders); // same key: same pool
+
+    void* a = plain.construct();
+    void* b = tagged.construct();
+    void* c = orders.construct();
+    void* d = quotes.construct();
+    CHECK(plain.owns(a) && !plain.owns(b) && !plain.owns(c));
+    CHECK(tagged.owns(b) && !tagged.owns(a));
+    CHECK(orders.owns(c) && !orders.owns(d));
+    CHECK(lookup(c).from == &orders);
+
+    plain.destruct(a);
+    tagged.destruct(b);
+    orders.destruct(c);
+    quotes.destruct(d);
+}
+
+// account tag of Tag::account: counted without scope
+void counted() {
+    account::usage before = account::total(order::account);
+
+    pool&  orders = pool::statics_for<order>();
+    order* ptr    = orders.construct<order>();
+    CHECK(orders.tag() == order::account);
+
+    account::usage after = account::total(order::account);
+    CHECK(after.count - before.count == 1);
+    CHECK(after.bytes - before.bytes >= int64_t(sizeof(order)));
+
+    orders.destruct(ptr);
+    CHECK(account::total(order::account).count == before.count);
+}
+
+int main() {
+    segregated();
+    counted();
+    return RESULT();
+}
@@ -5,6 +5,7 @@
 #include "vector"
 #include "iostream"
 #include "memory_resource"
+#include "cstring"
 #include "../pool/pool.hh"
 
 #include "boost/pool/singleton_pool.hpp"